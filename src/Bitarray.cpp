@@ -42,7 +42,7 @@ int bitarray::count() const
 {
   if (!init) return 0;
 
-  if (num_ones < 0) num_ones = count_ones_fast(bits, num_uls);
+  if (num_ones < 0) num_ones = bit_kernels.count(bits, num_uls);
   return num_ones;
 }
 
@@ -73,13 +73,9 @@ void bitarray::set()
 
 bitarray &bitarray::operator&=(const bitarray &ba)
 {
-  int i;
-  int num = num_uls;
-  unsigned long *bits_ptr = bits;
-  unsigned long *ba_ptr = ba.bits;
   if (!init) return *this;
 
-  for (i=0; i<num; i++) bits_ptr[i] &= ba_ptr[i];
+  bit_kernels.and_words(bits, ba.bits, num_uls);
 
   num_ones = -1;
   return *this;
@@ -87,13 +83,9 @@ bitarray &bitarray::operator&=(const bitarray &ba)
 
 bitarray &bitarray::operator|=(const bitarray &ba)
 {
-  int i;
-  int num = num_uls;
-  unsigned long *bits_ptr = bits;
-  unsigned long *ba_ptr = ba.bits;
   if (!init) return *this;
 
-  for (i=0; i<num; i++) bits_ptr[i] |= ba_ptr[i];
+  bit_kernels.or_words(bits, ba.bits, num_uls);
 
   num_ones = -1;
   return *this;
@@ -101,13 +93,9 @@ bitarray &bitarray::operator|=(const bitarray &ba)
 
 bitarray &bitarray::operator^=(const bitarray &ba)
 {
-  int i;
-  int num = num_uls;
-  unsigned long *bits_ptr = bits;
-  unsigned long *ba_ptr = ba.bits;
   if (!init) return *this;
 
-  for (i=0; i<num; i++) bits_ptr[i] ^= ba_ptr[i];
+  bit_kernels.xor_words(bits, ba.bits, num_uls);
 
   num_ones = -1;
   return *this;
@@ -115,18 +103,82 @@ bitarray &bitarray::operator^=(const bitarray &ba)
 
 bitarray &bitarray::flip()
 {
-  int i;
-  int num = num_uls;
-  unsigned long *bits_ptr = bits;
   if (!init) return *this;
 
-  for (i=0; i<num; i++) bits_ptr[i] = ~bits_ptr[i];
+  bit_kernels.not_words(bits, num_uls);
   bits[num_uls - 1] &= leftover_reset;
 
   num_ones = -1;
   return *this;
 }
 
+bitarray &bitarray::andnot(const bitarray &ba)
+{
+  if (!init) return *this;
+
+  bit_kernels.andnot_words(bits, ba.bits, num_uls);
+
+  num_ones = -1;
+  return *this;
+}
+
+int bitarray::and_count(const bitarray &ba) const
+{
+  if (!init) return 0;
+  return bit_kernels.and_count(bits, ba.bits, num_uls);
+}
+
+int bitarray::and_count(const bitarray &b1, const bitarray &b2) const
+{
+  if (!init) return 0;
+  return bit_kernels.and3_count(bits, b1.bits, b2.bits, num_uls);
+}
+
+int bitarray::andnot_count(const bitarray &ba) const
+{
+  if (!init) return 0;
+  return bit_kernels.andnot_count(bits, ba.bits, num_uls);
+}
+
+bool bitarray::intersects(const bitarray &ba) const
+{
+  int i;
+  if (!init) return 0;
+
+  for (i=0; i<num_uls; i++) if (bits[i] & ba.bits[i]) return 1;
+  return 0;
+}
+
+// Counts in blocks so that the answer is known as soon as k bits are found
+bool bitarray::and_count_at_least(const bitarray &ba, int k) const
+{
+  const int block = 16;
+  int i, len;
+  int sum = 0;
+  if (k <= 0) return 1;
+  if (!init) return 0;
+
+  for (i=0; i<num_uls; i += block)
+  {
+    len = (num_uls - i < block) ? num_uls - i : block;
+    sum += bit_kernels.and_count(bits + i, ba.bits + i, len);
+    if (sum >= k) return 1;
+  }
+
+  return 0;
+}
+
+// Stops at the first word with a bit outside super
+bool bitarray::and_subset(const bitarray &ba, const bitarray &super) const
+{
+  int i;
+  if (!init) return 1;
+
+  for (i=0; i<num_uls; i++)
+                     if (bits[i] & ba.bits[i] & ~super.bits[i]) return 0;
+  return 1;
+}
+
 bool bitarray::operator==(const bitarray &ba) const
 {
   if ((!init) || (!ba.init)) return 0;
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <cstdlib>
 #include "bit_counters.h"
+#include "bit_kernels.h"
 using namespace std;
 
 #define NUM_ULBITS (sizeof(unsigned long) * 8)
@@ -30,6 +31,8 @@ class bitarray
                                  // last UL if some operation, such as "not",
                                  // sets them.
   unsigned long *bits;
+  bool own_bits;  // False for views onto storage owned by someone else
+                  // (see attach)
 
   public:
 
@@ -42,6 +45,7 @@ class bitarray
     num_uls = 0;
     leftover_reset = 0;
     bits = 0;
+    own_bits = 1;
   }
 
   bitarray(int n)
@@ -57,6 +61,7 @@ class bitarray
     num_uls = n / NUM_ULBITS;
     if (n % NUM_ULBITS != 0) num_uls++;
     bits = new unsigned long[num_uls];
+    own_bits = 1;
     reset();
 
     leftover_reset = 0;
@@ -65,8 +70,10 @@ class bitarray
         leftover_reset <<= (NUM_ULBITS - BIT2ULPOS(num_bits));
   }
 
+  // Copies always own their storage, even when copied from a view
   bitarray(const bitarray &ba)
   {
+    own_bits = 1;
     num_ones = ba.num_ones;
     init = ba.init;
     num_bits = ba.num_bits;
@@ -80,9 +87,24 @@ class bitarray
     else {bits = 0;}
   }
 
-  // Assignment operator
+  // Assignment operator.  Assigning to a view copies the bits into the
+  // viewed storage, so the sizes must agree.
   bitarray &operator=(const bitarray &ba)
   {
+    if (this == &ba) return *this;
+    if (init && !own_bits)
+    {
+      if (!ba.init || ba.num_bits != num_bits)
+      {
+        cerr << "Error - bitarray view assigned a bitarray of another size."
+                                                                    << endl;
+        exit(EXIT_FAILURE);
+      }
+      memcpy(bits, ba.bits, num_uls * NUM_ULBITS / 8);
+      num_ones = ba.num_ones;
+      return *this;
+    }
+
     if (init) delete [] bits;
     if (ba.init)
     {
@@ -101,7 +123,39 @@ class bitarray
   }
 
   // Destructor
-  ~bitarray() {if (init) delete [] bits;}
+  ~bitarray() {if (init && own_bits) delete [] bits;}
+
+  // Turn an uninitialized bitarray into a view of n bits stored at buf,
+  // which must hold words_for(n) words and outlive the view.  The contents
+  // of buf are left as they are.  Used by Graph to lay its adjacency rows
+  // out in one contiguous block.
+  void attach(unsigned long *buf, int n)
+  {
+    if (init)
+    {
+      cerr << "Error - attach called on an initialized bitarray." << endl;
+      exit(EXIT_FAILURE);
+    }
+    num_ones = -1;
+    init = 1;
+    own_bits = 0;
+    num_bits = n;
+    num_uls = words_for(n);
+    bits = buf;
+
+    leftover_reset = 0;
+    leftover_reset = ~leftover_reset;
+    if (BIT2ULPOS(num_bits) != 0)
+        leftover_reset <<= (NUM_ULBITS - BIT2ULPOS(num_bits));
+  }
+
+  // Number of unsigned longs needed to hold n bits
+  static int words_for(int n)
+             {return n / NUM_ULBITS + ((n % NUM_ULBITS != 0) ? 1 : 0);}
+
+  // Raw word access for kernels that work on several rows at once
+  const unsigned long *words() const {return bits;}
+  int num_words() const {return num_uls;}
 
   // Accessor functions
   bool ready() const {return init;}
@@ -129,6 +183,7 @@ class bitarray
     num_uls = n / NUM_ULBITS;
     if (n % NUM_ULBITS != 0) num_uls++;
     bits = new unsigned long[num_uls];
+    own_bits = 1;
     reset();
 
     leftover_reset = 0;
@@ -137,6 +192,14 @@ class bitarray
         leftover_reset <<= (NUM_ULBITS - BIT2ULPOS(num_bits));
   }
 
+  // Copy the bits of a bitarray of the same size into this one's storage
+  // without reallocating
+  void assign(const bitarray &ba)
+  {
+    memcpy(bits, ba.bits, num_uls * NUM_ULBITS / 8);
+    num_ones = ba.num_ones;
+  }
+
   // Single Bit manipulations
   void flip(int);
   void reset(int);
@@ -175,6 +238,20 @@ class bitarray
     return tba;
   }
 
+  // Fused operations.  Each combines a logical operation with a count or
+  // test in a single pass over the words and never builds a temporary
+  // bitarray, so they should be preferred in inner loops.
+  bitarray &andnot(const bitarray &ba);               // *this &= ~ba
+  int and_count(const bitarray &ba) const;            // (*this & ba).count()
+  int and_count(const bitarray &b1, const bitarray &b2) const;
+                                                 // (*this & b1 & b2).count()
+  int andnot_count(const bitarray &ba) const;         // (*this & ~ba).count()
+  bool intersects(const bitarray &ba) const;          // (*this & ba).count() > 0
+  bool and_count_at_least(const bitarray &ba, int k) const;
+                                                 // (*this & ba).count() >= k
+  bool and_subset(const bitarray &ba, const bitarray &super) const;
+                                         // (*this & ba) is a subset of super
+
   // Comparison operator
   bool operator==(const bitarray &ba) const;
 };
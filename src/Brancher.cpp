@@ -1,4 +1,15 @@
+#include <typeinfo>
 #include "Brancher.h"
+#include "Static_Brancher.h"
+
+// Statistics of this thread's find_mcl calls not yet reported.  The threads
+// of a Par_Brancher share one Brancher, so its counters are kept per thread.
+static thread_local Search_Stats thread_stats;
+
+void Brancher::report_thread_stats()
+{
+  report_search_stats(thread_stats);
+}
 
 int Brancher::operator() (Graph &mygraph, Graph::Vertices &maximum_clique) const
 {
@@ -9,7 +20,9 @@ int Brancher::operator() (Graph &mygraph, Graph::Vertices &maximum_clique) const
                                              return maximum_clique.size();
   Graph::Vertices v(mygraph);
   v.fill();
-  find_mcl(v, maximum_clique);
+  if (!run_static(v, maximum_clique)) find_mcl(v, maximum_clique);
+  if (par_imp) par_finish(maximum_clique);
+  report_thread_stats();
   return maximum_clique.size();
 }
 
@@ -21,17 +34,20 @@ int Brancher::operator() (Graph::Vertices &mygraph,
   if (par_imp)
     if (par_init(*(mygraph.graph()), maximum_clique) == NO_RUN_AFTER_INIT)
                                               return maximum_clique.size();
-  find_mcl(mygraph, maximum_clique);
+  if (!run_static(mygraph, maximum_clique)) find_mcl(mygraph, maximum_clique);
+  if (par_imp) par_finish(maximum_clique);
+  report_thread_stats();
   return maximum_clique.size();
 }
 
 void Brancher::find_mcl(Graph::Vertices mygraph,
                         Graph::Vertices &maximum_clique,
-                        Graph::Vertices *clique_so_far) const
+                        Graph::Vertices *clique_so_far, int depth) const
 {
-  static int big_count = 0;
-  static int depth = 0;
+  // Depth is per call (not static) so that threads can search concurrently
   ++depth;
+  ++thread_stats.branches;
+  if (done(maximum_clique)) return;
 
   int num_nodes_needed;
   int cand;
@@ -45,7 +61,7 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
   // Branch-level Interleaved and Degree Preprocessing
   if (branch_ipp)
   {
-    num_nodes_needed = maximum_clique.size() + 1 - current_clique.size();
+    num_nodes_needed = bound(maximum_clique) + 1 - current_clique.size();
     if (num_nodes_needed > 1) (*branch_ipp)(mygraph, num_nodes_needed, depth);
   }
 
@@ -56,13 +72,11 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
   }
 
   Candidate_Manager *cand_man = branch_cand_man->create();
-  cand_man->init(&mygraph, maximum_clique.size() + 1, &current_clique);
+  cand_man->init(&mygraph, bound(maximum_clique) + 1, &current_clique);
   update_maximum_clique(maximum_clique, current_clique);
-  while ((cand = cand_man->next(&mygraph, maximum_clique.size() + 1,
+  while ((cand = cand_man->next(&mygraph, bound(maximum_clique) + 1,
                                                      &current_clique)) != -1)
   {
-    ++big_count;
-
     if (search_best_to_worst)
     {
       // Assume cand is in clique
@@ -77,7 +91,7 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
         if (par_find_mcl(tmpgraph, maximum_clique, &current_clique, depth) ==
                                                           HALT_SEARCH) return;
       }
-      else find_mcl(tmpgraph, maximum_clique, &current_clique);
+      else find_mcl(tmpgraph, maximum_clique, &current_clique, depth);
 
       if (par_imp)
         if (par_checkin(tmpgraph, maximum_clique, &current_clique, depth) ==
@@ -86,6 +100,11 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
       // Assume cand is not in clique
       current_clique.remove(cand);
       mygraph.remove(cand);
+
+      // Every clique with a candidate cand dominates has a counterpart of
+      // the same size with cand, and those were just searched
+      if (branch_dominance)
+                thread_stats.dominated += mygraph.remove_dominated(cand);
     }
 
     else
@@ -99,7 +118,7 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
         if (par_find_mcl(mygraph, maximum_clique, &current_clique, depth) ==
                                                          HALT_SEARCH) return;
       }
-      else find_mcl(mygraph, maximum_clique, &current_clique);
+      else find_mcl(mygraph, maximum_clique, &current_clique, depth);
 
       if (par_imp)
         if (par_checkin(mygraph, maximum_clique, &current_clique, depth) ==
@@ -114,7 +133,7 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
     // Node-level Interleaved and Degree Preprocessing
     if (node_ipp)
     {
-      num_nodes_needed = maximum_clique.size() + 1 - current_clique.size();
+      num_nodes_needed = bound(maximum_clique) + 1 - current_clique.size();
       if (num_nodes_needed > 1) (*node_ipp)(mygraph, num_nodes_needed, depth);
     }
 
@@ -125,14 +144,53 @@ void Brancher::find_mcl(Graph::Vertices mygraph,
     }
 
     // Simple search tree pruning
-    if (mygraph.size() + current_clique.size() <= maximum_clique.size()) break;
+    if (mygraph.size() + current_clique.size() <= bound(maximum_clique)) break;
+    if (done(maximum_clique)) break;
   }
 
   delete cand_man;
   update_maximum_clique(maximum_clique, current_clique);
+}
+
+template <class Cand_Man, bool best_to_worst>
+static void branch_static(Graph::Vertices &mygraph,
+                          Graph::Vertices &maximum_clique, bool dominance,
+                                                          int max_size)
+{
+  Static_Brancher<Cand_Man, best_to_worst> branch((Own_Bound(max_size)));
+  branch.set_dominance(dominance);
+  branch(mygraph, maximum_clique);
+}
+
+// Hand the search to a Static_Brancher when nothing in the configuration
+// needs the general loop:  a serial search with one of the bitset color
+// managers and no interleaved or degree preprocessing.  The candidate
+// manager's type is looked up once here rather than at every search node.
+bool Brancher::run_static(Graph::Vertices &mygraph,
+                          Graph::Vertices &maximum_clique) const
+{
+  if (par_imp || branch_ipp || node_ipp || branch_dpp || node_dpp) return 0;
+
+  const type_info &cm = typeid(*branch_cand_man);
+  if (cm == typeid(Sat_Color_Man))
+  {
+    if (search_best_to_worst)
+      branch_static<Sat_Color_Man, 1>(mygraph, maximum_clique,
+                                      branch_dominance, branch_max_size);
+    else branch_static<Sat_Color_Man, 0>(mygraph, maximum_clique, 0,
+                                                       branch_max_size);
+  }
+  else if (cm == typeid(Bitset_Color_Man))
+  {
+    if (search_best_to_worst)
+      branch_static<Bitset_Color_Man, 1>(mygraph, maximum_clique,
+                                      branch_dominance, branch_max_size);
+    else branch_static<Bitset_Color_Man, 0>(mygraph, maximum_clique, 0,
+                                                       branch_max_size);
+  }
+  else return 0;
 
-  --depth;
-  // if (depth == 0) cerr << "Number of iterations:  " << big_count << endl;
+  return 1;
 }
 
 void Brancher::update_maximum_clique(Graph::Vertices &m, Graph::Vertices &c)
@@ -30,6 +30,14 @@ class Brancher
   Preprocessor *branch_ipp;
   Preprocessor *node_ipp;
 
+  // Remove the candidates a node dominates once its branch is searched
+  // (best to worst search only; see Graph::Vertices::remove_dominated)
+  bool branch_dominance;
+
+  // Stop once a clique of this size is found, if positive (a known upper
+  // bound on the clique size)
+  int branch_max_size;
+
   // Only for use by derived classes that have parallel implementations
   // (see below)
   protected:
@@ -44,6 +52,8 @@ class Brancher
     node_dpp = 0;
     branch_ipp = 0;
     node_ipp = 0;
+    branch_dominance = 0;
+    branch_max_size = 0;
     par_imp = 0;
   }
 
@@ -61,15 +71,19 @@ class Brancher
   void node_dpp_on() {node_dpp = 1;}
   void set_branch_ipp(Preprocessor *p) {branch_ipp = p;}
   void set_node_ipp(Preprocessor *p) {node_ipp = p;}
+  void dominance_on() {branch_dominance = 1;}
+  void dominance_off() {branch_dominance = 0;}
+  void set_max_size(int s) {branch_max_size = s;}
 
   // Main Operation
   int operator() (Graph &, Graph::Vertices &) const;
   int operator() (Graph::Vertices &, Graph::Vertices &) const;
 
   protected:
-  // The core branching function
+  // The core branching function.  depth is the depth of the caller in the
+  // search tree.
   void find_mcl(Graph::Vertices mygraph, Graph::Vertices &maximum_clique,
-                                Graph::Vertices *current_clique = 0) const;
+                Graph::Vertices *current_clique = 0, int depth = 0) const;
 
   // Hooks added Nov. 6, 2006 to allow parallel implementations by
   // derived classes.  These are called at the appropriate places
@@ -86,12 +100,27 @@ class Brancher
                           Graph::Vertices &maximum_clique,
                           Graph::Vertices *current_clique, int depth)
                                                     const {return CONT_SEARCH;}
+  // Called by the initial thread once its own branching is done
+  virtual void par_finish(Graph::Vertices &maximum_clique) const {}
+  // Size a clique must beat to be of interest (at least the size of
+  // maximum_clique; may be larger when searches share a bound)
+  virtual int par_bound(Graph::Vertices &maximum_clique) const
+                                             {return maximum_clique.size();}
+
+  // Add the calling thread's search statistics to the totals.  Threads
+  // other than the one that called operator() must call this when done.
+  static void report_thread_stats();
 
   // Compare maximum clique size with size of current clique and update if
   // latter is larger.  For version 4.1, we do this simple operation frequently,
   // and hence encapsulating it is appropriate.
   private:
   void update_maximum_clique(Graph::Vertices &, Graph::Vertices &) const;
+  bool run_static(Graph::Vertices &, Graph::Vertices &) const;
+  int bound(Graph::Vertices &maximum_clique) const
+      {return par_imp ? par_bound(maximum_clique) : maximum_clique.size();}
+  bool done(Graph::Vertices &maximum_clique) const
+      {return branch_max_size > 0 && bound(maximum_clique) >= branch_max_size;}
 };
 
 #endif
@@ -19,14 +19,49 @@ int Candidate_Manager::next(Graph::Vertices *v, int min_clique_size,
 void Lazy_Low_Degree_Man::init(Graph::Vertices *v, int min_clique_size,
                                                        Graph::Vertices *clique)
 {
+  int i;
+  vector<int> deg(v->graph()->max_size());
+
+  // Count each degree once rather than at every comparison
   Candidate_Manager::init(v);
-  sort(cand_list.begin(), cand_list.end(), Graph_vertices_deg_sort_asc(*v));
+  for (i=0; i<(int)cand_list.size(); ++i)
+                                  deg[cand_list[i]] = v->degree(cand_list[i]);
+  sort(cand_list.begin(), cand_list.end(), vector_sort_asc(deg));
 }
 
-int Prep_High_Degree_Man::next(Graph::Vertices *v, int min_clique_size,
-                                                       Graph::Vertices *clique)
+void Prep_Degree_Man::init(Graph::Vertices *v, int min_clique_size,
+                                                   Graph::Vertices *clique)
+{
+  Candidate_Manager::init(v);
+  scanned = 0;
+  bucketed = 0;
+}
+
+int Prep_Degree_Man::select(Graph::Vertices *v, int min_clique_size,
+                                         Graph::Vertices *clique, bool high)
+{
+  int cand;
+
+  // Searches often stop after one candidate, so buckets wait for a second
+  if (bucketed) sync(v);
+  else if (scanned && v->size() >= PREP_BUCKET_MIN) start(v);
+  if (!bucketed)
+  {
+    scanned = 1;
+    return scan(v, min_clique_size, clique, high);
+  }
+
+  if (!prep(v, min_clique_size, clique)) return -1;
+  cand = high ? highest() : lowest();
+  if (cand != -1) drop(cand);
+  return cand;
+}
+
+// One pass over the candidates, counting each degree
+int Prep_Degree_Man::scan(Graph::Vertices *v, int min_clique_size,
+                                          Graph::Vertices *clique, bool high)
 {
-  int deg, best_degree = -1;
+  int deg, best_degree = high ? -1 : v->size();
   int size;
   int clique_size = clique->size();
   vector<int>::iterator cand, best_cand = cand_list.end();
@@ -69,7 +104,7 @@ int Prep_High_Degree_Man::next(Graph::Vertices *v, int min_clique_size,
       continue;
     }
 
-    if (deg > best_degree)
+    if (high ? deg > best_degree : deg < best_degree)
     {
       best_cand = cand;
       best_degree = deg;
@@ -83,76 +118,186 @@ int Prep_High_Degree_Man::next(Graph::Vertices *v, int min_clique_size,
   *best_cand = -1;
 
   // In rare cases, the n-2 rule may remove the best candidate.  In this
-  // case, we just recompute the highest degree vertex without preprocessing
-  // using the hdvertex built-in Graph library routine.
-  if (!v->in_set(cand_id)) cand_id = v->hdvertex();
+  // case, we just recompute the highest (lowest) degree vertex without
+  // preprocessing using the hdvertex (ldvertex) built-in Graph library
+  // routine.
+  if (!v->in_set(cand_id)) cand_id = high ? v->hdvertex() : v->ldvertex();
   return cand_id;
 }
 
-int Prep_Low_Degree_Man::next(Graph::Vertices *v, int min_clique_size,
-                                                      Graph::Vertices *clique)
+void Prep_Degree_Man::link(int n)
 {
-  int deg, best_degree = v->size();
-  int size;
-  int clique_size = clique->size();
-  vector<int>::iterator cand, best_cand = cand_list.end();
+  bucket_prev[n] = -1;
+  bucket_next[n] = head[deg[n]];
+  if (head[deg[n]] != -1) bucket_prev[head[deg[n]]] = n;
+  head[deg[n]] = n;
+}
 
-  for (cand = cand_list.begin(); cand != cand_list.end();)
+void Prep_Degree_Man::unlink(int n)
+{
+  if (bucket_prev[n] != -1) bucket_next[bucket_prev[n]] = bucket_next[n];
+  else head[deg[n]] = bucket_next[n];
+  if (bucket_next[n] != -1) bucket_prev[bucket_next[n]] = bucket_prev[n];
+}
+
+void Prep_Degree_Man::start(Graph::Vertices *v)
+{
+  g = v->graph();
+  deg.resize(g->max_size());
+  head.assign(g->max_size() + 1, -1);
+  bucket_next.resize(g->max_size());
+  bucket_prev.resize(g->max_size());
+  max_deg = 0;
+  rebuild(v);
+  bucketed = 1;
+}
+
+// Fill the buckets with the nodes of v and their degrees
+void Prep_Degree_Man::rebuild(Graph::Vertices *v)
+{
+  int i, n;
+  unsigned long word;
+
+  for (i=0; i<=max_deg; ++i) head[i] = -1;
+  known.assign(v->words(), v->words() + v->num_words());
+  num_known = 0;
+  min_deg = 0;
+  max_deg = 0;
+  for (i=0; i<(int)known.size(); ++i)
   {
-    if (*cand == -1) {++cand; continue;}
-    if (!v->in_set(*cand)) {*cand = -1; ++cand; continue;}
+    for (word = known[i]; word; word &= word - 1)
+    {
+      n = i * NUM_ULBITS + NUM_ULBITS - 1 - __builtin_ctzl(word);
+      deg[n] = v->degree(n);
+      link(n);
+      max_deg = max(max_deg, deg[n]);
+      ++num_known;
+    }
+  }
+}
 
-    deg = v->degree(*cand);
-    size = v->size();
+// Catch up with nodes removed from v by the caller.  Once few nodes are
+// left, scanning is cheaper and the buckets are abandoned.
+void Prep_Degree_Man::sync(Graph::Vertices *v)
+{
+  int i, gone = 0;
+  unsigned long word;
+  const unsigned long *vw = v->words();
 
-    // Preprocess nodes of too low or too high degree
-    if (deg < min_clique_size - clique_size - 1)
+  for (i=0; i<(int)known.size(); ++i)
+                             gone += __builtin_popcountl(known[i] & ~vw[i]);
+  if (num_known - gone < PREP_BUCKET_MIN) bucketed = 0;
+  else if (gone > num_known - gone) rebuild(v);
+  else
+  {
+    for (i=0; i<(int)known.size(); ++i)
     {
-      v->remove(*cand);
-      *cand = -1;
-      ++cand;
-      continue;
+      for (word = known[i] & ~vw[i]; word; word &= word - 1)
+               drop(i * NUM_ULBITS + NUM_ULBITS - 1 - __builtin_ctzl(word));
     }
+  }
+}
 
-    if (deg == size-1)
+// Remove n from the buckets and lower the degrees of its neighbors
+void Prep_Degree_Man::drop(int n)
+{
+  int i, nbr;
+  unsigned long word;
+  const unsigned long *row = g->row(n);
+
+  unlink(n);
+  known[BIT2UL(n)] &= ~(1UL << (NUM_ULBITS - 1 - BIT2ULPOS(n)));
+  --num_known;
+
+  for (i=0; i<(int)known.size(); ++i)
+  {
+    for (word = known[i] & row[i]; word; word &= word - 1)
     {
-      v->remove(*cand);
-      clique->insert(*cand);
-      ++clique_size;
-      *cand = -1;
-      ++cand;
-      continue;
+      nbr = i * NUM_ULBITS + NUM_ULBITS - 1 - __builtin_ctzl(word);
+      unlink(nbr);
+      --deg[nbr];
+      link(nbr);
+      min_deg = min(min_deg, deg[nbr]);
     }
+  }
+}
 
-    if (deg == size-2)
+int Prep_Degree_Man::lowest()
+{
+  if (num_known == 0) return -1;
+  while (head[min_deg] == -1) ++min_deg;
+  return head[min_deg];
+}
+
+int Prep_Degree_Man::highest()
+{
+  if (num_known == 0) return -1;
+  while (head[max_deg] == -1) --max_deg;
+  return head[max_deg];
+}
+
+// The rules of scan, on the buckets.  False if the clique can no longer
+// reach min_clique_size.
+bool Prep_Degree_Man::prep(Graph::Vertices *v, int min_clique_size,
+                                                   Graph::Vertices *clique)
+{
+  int i, n, nn;
+  int clique_size = clique->size();
+  unsigned long word;
+  const unsigned long *row;
+
+  while (num_known > 0 && clique_size + num_known >= min_clique_size)
+  {
+    // Preprocess nodes of too low or too high degree
+    n = lowest();
+    if (deg[n] < min_clique_size - clique_size - 1)
     {
-      v->remove_nnbrs(*cand);
-      v->remove(*cand);
-      clique->insert(*cand);
-      ++clique_size;
-      *cand = -1;
-      ++cand;
+      v->remove(n);
+      drop(n);
       continue;
     }
 
-    if (deg < best_degree)
+    if (head[num_known-1] != -1) n = head[num_known-1];
+    else if (num_known >= 2 && head[num_known-2] != -1)
     {
-      best_cand = cand;
-      best_degree = deg;
+      // Drop the one non-neighbor of n as well
+      n = head[num_known-2];
+      row = g->row(n);
+      nn = -1;
+      for (i=0; i<(int)known.size() && nn == -1; ++i)
+      {
+        word = known[i] & ~row[i];
+        if (i == (int)BIT2UL(n))
+                     word &= ~(1UL << (NUM_ULBITS - 1 - BIT2ULPOS(n)));
+        if (word) nn = i * NUM_ULBITS + __builtin_clzl(word);
+      }
+      if (nn != -1)
+      {
+        v->remove(nn);
+        drop(nn);
+      }
     }
+    else break;
 
-    ++cand;
+    v->remove(n);
+    clique->insert(n);
+    ++clique_size;
+    drop(n);
   }
 
-  if (best_cand == cand_list.end()) return -1;
-  int cand_id = *best_cand;
-  *best_cand = -1;
+  return clique_size + num_known >= min_clique_size;
+}
 
-  // In rare cases, the n-2 rule may remove the best candidate.  In this
-  // case, we just recompute the lowest degree vertex without preprocessing
-  // using the ldvertex built-in Graph library routine.
-  if (!v->in_set(cand_id)) cand_id = v->ldvertex();
-  return cand_id;
+int Prep_High_Degree_Man::next(Graph::Vertices *v, int min_clique_size,
+                                                       Graph::Vertices *clique)
+{
+  return select(v, min_clique_size, clique, 1);
+}
+
+int Prep_Low_Degree_Man::next(Graph::Vertices *v, int min_clique_size,
+                                                      Graph::Vertices *clique)
+{
+  return select(v, min_clique_size, clique, 0);
 }
 
 void Lazy_High_Color_Man::init(Graph::Vertices *v, int min_clique_size,
@@ -183,3 +328,50 @@ int Lazy_High_Color_Man::next(Graph::Vertices *v, int min_clique_size,
 
   return -1;
 }
+
+void Bitset_Color_Man::init(Graph::Vertices *v, int min_clique_size,
+                                                     Graph::Vertices *clique)
+{
+  coloring.color(*v, cand_list, color);
+  next_cand = cand_list.size();
+}
+
+int Bitset_Color_Man::next(Graph::Vertices *v, int min_clique_size,
+                                                     Graph::Vertices *clique)
+{
+  int clique_size = clique ? clique->size() : 0;
+
+  while (next_cand > 0)
+  {
+    --next_cand;
+    if (clique_size + color[next_cand] < min_clique_size) return -1;
+    if (v->in_set(cand_list[next_cand])) return cand_list[next_cand];
+  }
+  return -1;
+}
+
+void Sat_Color_Man::init(Graph::Vertices *v, int min_clique_size,
+                                                  Graph::Vertices *clique)
+{
+  int clique_size = clique ? clique->size() : 0;
+
+  Bitset_Color_Man::init(v, min_clique_size, clique);
+  init_clique_size = clique_size;
+  pruned.assign(cand_list.size(), 0);
+  coloring.sat_prune(min_clique_size - clique_size, cand_list, color, pruned);
+}
+
+int Sat_Color_Man::next(Graph::Vertices *v, int min_clique_size,
+                                                  Graph::Vertices *clique)
+{
+  int clique_size = clique ? clique->size() : 0;
+
+  while (next_cand > 0)
+  {
+    --next_cand;
+    if (clique_size + color[next_cand] < min_clique_size) return -1;
+    if (pruned[next_cand] && clique_size == init_clique_size) continue;
+    if (v->in_set(cand_list[next_cand])) return cand_list[next_cand];
+  }
+  return -1;
+}
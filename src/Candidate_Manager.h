@@ -42,8 +42,60 @@ class Lazy_Low_Degree_Man : public Candidate_Manager
   Lazy_Low_Degree_Man *create() const {return new Lazy_Low_Degree_Man();}
 };
 
+// Subproblems of at least this many nodes keep their degrees in buckets
+// (see Prep_Degree_Man); a scan of popcounts is cheaper below it
+#define PREP_BUCKET_MIN 256
+
+// Base of the preprocessing degree managers.  Candidates of too low degree
+// are dropped, and candidates adjacent to all others but at most one are
+// moved into the clique (the n-1 and n-2 rules).  A manager asked for more
+// than one candidate from a large subproblem computes the degrees within v
+// once and keeps them in buckets by degree, updated as nodes leave v, so
+// each selection and rule costs amortized constant time rather than a
+// degree count per candidate.  Nodes the caller removes from v between
+// calls are picked up at the next call (the buckets are rebuilt instead if
+// most nodes are gone); the caller must remove each candidate returned.
+class Prep_Degree_Man : public Candidate_Manager
+{
+  bool scanned;                 // A selection has been made
+  bool bucketed;
+  Graph *g;
+  vector<unsigned long> known;  // Nodes of v as of the last update
+  vector<int> deg;              // Degree within known
+  vector<int> head;             // First node of each degree, or -1
+  vector<int> bucket_next;
+  vector<int> bucket_prev;
+  int num_known;
+  int min_deg;                  // No bucket below min_deg is used
+  int max_deg;                  // No bucket above max_deg is used
+
+  public:
+  Prep_Degree_Man()
+  :scanned(0), bucketed(0), g(0), num_known(0), min_deg(0), max_deg(0) {}
+  void init(Graph::Vertices *v, int min_clique_size = 0,
+                                               Graph::Vertices *clique = 0);
+
+  protected:
+  // Preprocess, then return the highest (or lowest) degree candidate
+  int select(Graph::Vertices *v, int min_clique_size,
+                                        Graph::Vertices *clique, bool high);
+
+  private:
+  int scan(Graph::Vertices *v, int min_clique_size,
+                                        Graph::Vertices *clique, bool high);
+  bool prep(Graph::Vertices *v, int min_clique_size, Graph::Vertices *clique);
+  void start(Graph::Vertices *v);
+  void sync(Graph::Vertices *v);
+  void rebuild(Graph::Vertices *v);
+  void drop(int n);
+  void unlink(int n);
+  void link(int n);
+  int lowest();
+  int highest();
+};
+
 // A high-degree manager that also will preprocess the graph.
-class Prep_High_Degree_Man : public Candidate_Manager
+class Prep_High_Degree_Man : public Prep_Degree_Man
 {
   public:
   int next(Graph::Vertices *v, int min_clique_size = 0,
@@ -52,7 +104,7 @@ class Prep_High_Degree_Man : public Candidate_Manager
 };
 
 // A low-degree manager that also will preprocess the graph.
-class Prep_Low_Degree_Man : public Candidate_Manager
+class Prep_Low_Degree_Man : public Prep_Degree_Man
 {
   public:
   int next(Graph::Vertices *v, int min_clique_size = 0,
@@ -77,4 +129,42 @@ class Lazy_High_Color_Man : public Candidate_Manager
   Lazy_High_Color_Man *create() const {return new Lazy_High_Color_Man();}
 };
 
+// Recolors the candidates at every search node and branches on them in
+// decreasing color order, stopping as soon as the clique plus the color of
+// the next candidate cannot reach min_clique_size (the coloring bound used
+// by bitset solvers such as BBMC).  Coloring works on whole words (see
+// Bitset_Coloring), so candidates are colored in node number order.
+class Bitset_Color_Man : public Candidate_Manager
+{
+  protected:
+  vector<int> color;  // Color (from 1) of cand_list[i]; non-decreasing
+  Bitset_Coloring coloring;
+
+  public:
+  void init(Graph::Vertices *v, int min_clique_size = 0,
+                                               Graph::Vertices *clique = 0);
+  int next(Graph::Vertices *v, int min_clique_size = 0,
+                                               Graph::Vertices *clique = 0);
+  Bitset_Color_Man *create() const {return new Bitset_Color_Man();}
+};
+
+// Bitset_Color_Man with the coloring bound tightened by MaxSAT reasoning
+// (see Bitset_Coloring::sat_prune).  Candidates whose color is high enough
+// to be branched on are skipped if unit propagation shows that they cannot
+// extend the clique to min_clique_size together with the lower classes.
+// Pruning only holds for the clique given to init, so candidates are no
+// longer skipped once the clique has grown (as in worst to best search).
+class Sat_Color_Man : public Bitset_Color_Man
+{
+  vector<char> pruned;
+  int init_clique_size;
+
+  public:
+  void init(Graph::Vertices *v, int min_clique_size = 0,
+                                               Graph::Vertices *clique = 0);
+  int next(Graph::Vertices *v, int min_clique_size = 0,
+                                               Graph::Vertices *clique = 0);
+  Sat_Color_Man *create() const {return new Sat_Color_Man();}
+};
+
 #endif
@@ -22,6 +22,24 @@ bool Edge_Test::operator() (const Graph::Vertices &v, int min_size, int node)
   return 1;
 }
 
+bool MaxSAT_Test::operator() (const Graph::Vertices &v, int min_size,
+                                                      int node) const
+{
+  if (node != -1)
+  {
+    cerr << "Error - MaxSAT test called with specific node." << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  Bitset_Coloring coloring;
+  vector<int> nodes, colors;
+  vector<char> pruned;
+
+  if (coloring.color(v, nodes, colors) < min_size) return 1;
+  pruned.assign(nodes.size(), 0);
+  return coloring.sat_prune(min_size, nodes, colors, pruned) == 0;
+}
+
 int Lazy_Color_Test::num_colors(const Graph::Vertices &v, int node) const
 {
   int i;
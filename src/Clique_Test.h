@@ -35,7 +35,7 @@ class Size_Test : public Clique_Test
 
   bool operator() (const Graph::Vertices &v, int min_size, int node) const
   {
-    if (node != -1) return v.degree(node) < min_size - 1;
+    if (node != -1) return !v.degree_at_least(node, min_size - 1);
     return v.size() < min_size;
   }
 };
@@ -81,6 +81,15 @@ class Color_Test : public Clique_Test
   }
 };
 
+// Coloring bound tightened by MaxSAT reasoning (see Bitset_Coloring)
+class MaxSAT_Test : public Clique_Test
+{
+  public:
+  MaxSAT_Test() :Clique_Test(1) {}
+
+  bool operator() (const Graph::Vertices &v, int min_size, int node) const;
+};
+
 class Lazy_Color_Test : public Clique_Test
 {
   const vector<int> &node2color;
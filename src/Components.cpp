@@ -0,0 +1,87 @@
+#include <algorithm>
+#include "Components.h"
+
+int connected_components(const Graph::Vertices &v,
+                                           vector<vector<int> > &comps)
+{
+  int i, j, b, n, s;
+  int nw = v.num_words();
+  unsigned long w;
+  bool more;
+  const unsigned long *r;
+  vector<unsigned long> left(v.words(), v.words() + nw);
+  vector<unsigned long> frontier(nw), reached(nw);
+
+  comps.clear();
+  for (s=0; s<nw; )
+  {
+    if (left[s] == 0) {++s; continue;}
+
+    // Start a component at the first node left
+    b = __builtin_clzl(left[s]);
+    fill(frontier.begin(), frontier.end(), 0);
+    frontier[s] = 1UL << (NUM_ULBITS - 1 - b);
+    left[s] &= ~frontier[s];
+    comps.push_back(vector<int>());
+
+    do
+    {
+      fill(reached.begin(), reached.end(), 0);
+      for (i=0; i<nw; i++)
+      {
+        for (w = frontier[i]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+        {
+          b = __builtin_clzl(w);
+          n = i * NUM_ULBITS + b;
+          comps.back().push_back(n);
+          r = v.graph()->row(n);
+          for (j=0; j<nw; j++) reached[j] |= r[j];
+        }
+      }
+
+      more = 0;
+      for (i=0; i<nw; i++)
+      {
+        frontier[i] = reached[i] & left[i];
+        left[i] &= ~frontier[i];
+        if (frontier[i]) more = 1;
+      }
+    } while (more);
+
+    sort(comps.back().begin(), comps.back().end());
+  }
+
+  return comps.size();
+}
+
+Graph *component_graph(const Graph &g, const vector<int> &nodes)
+{
+  int i, j, b, n;
+  unsigned long w;
+  const unsigned long *r;
+  Graph *sub = new Graph(0, max(1, (int)nodes.size()));
+  vector<int> local(g.max_size(), -1);
+
+  for (i=0; i<(int)nodes.size(); ++i)
+  {
+    local[nodes[i]] = i;
+    sub->create_new_node(g.label(nodes[i]));
+  }
+
+  // Each edge once, from its endpoint with the lower position
+  for (i=0; i<(int)nodes.size(); ++i)
+  {
+    r = g.row(nodes[i]);
+    for (j=0; j<g.row_words(); j++)
+    {
+      for (w = r[j]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+      {
+        b = __builtin_clzl(w);
+        n = local[j * NUM_ULBITS + b];
+        if (n > i) sub->connect(i, n);
+      }
+    }
+  }
+
+  return sub;
+}
@@ -0,0 +1,24 @@
+// Connected components
+// Components are found by breadth-first search a word at a time:  each step
+// ORs together the rows of the nodes in the frontier, and the members of
+// the set reached for the first time form the next frontier.  Maximum
+// clique and paraclique searches use them to work on one piece of a graph
+// at a time.
+
+#ifndef _COMPONENTS_H
+#define _COMPONENTS_H 1
+
+#include <vector>
+#include "Graph.h"
+using namespace std;
+
+// Connected components of the subgraph induced by v, each a list of nodes
+// in increasing order.  Returns the number of components.  O(n^2/64).
+int connected_components(const Graph::Vertices &v,
+                                           vector<vector<int> > &comps);
+
+// New graph induced by nodes.  Node i of the new graph is nodes[i] and
+// keeps its label.
+Graph *component_graph(const Graph &g, const vector<int> &nodes);
+
+#endif
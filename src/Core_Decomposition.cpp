@@ -0,0 +1,54 @@
+#include "Core_Decomposition.h"
+
+// Adjacency view of a vertex set of a dense Graph
+class Dense_Adj
+{
+  const Graph::Vertices &v;
+  const Graph *g;
+
+  public:
+  Dense_Adj(const Graph::Vertices &vs) :v(vs), g(vs.graph()) {}
+  int size() const {return g->max_size();}
+  bool alive(int n) const {return v.in_set(n);}
+  int degree(int n) const {return v.degree(n);}
+  void nbrs(int n, vector<int> &dest) const
+  {
+    int i, b;
+    unsigned long w;
+    const unsigned long *r = g->row(n);
+    const unsigned long *in = v.words();
+
+    dest.clear();
+    for (i=0; i<v.num_words(); i++)
+    {
+      for (w = r[i] & in[i]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+      {
+        b = __builtin_clzl(w);
+        dest.push_back(i * NUM_ULBITS + b);
+      }
+    }
+  }
+};
+
+void core_order(const Graph::Vertices &v, vector<int> &order,
+                                          vector<int> &core)
+{
+  peel(Dense_Adj(v), order, core);
+}
+
+int Core_Preprocessor(Graph::Vertices &mygraph, int min_clique_size)
+{
+  int i, num_removed = 0;
+  vector<int> order, core;
+
+  if (min_clique_size < 2) return 0;
+  core_order(mygraph, order, core);
+  for (i=0; i<(int)order.size(); ++i)
+  {
+    if (core[order[i]] >= min_clique_size - 1) continue;
+    mygraph.remove(order[i]);
+    ++num_removed;
+  }
+
+  return num_removed;
+}
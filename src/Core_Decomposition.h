@@ -0,0 +1,89 @@
+// Core decomposition
+// Peels a graph by repeatedly removing a node of least remaining degree
+// (Batagelj and Zaversnik, O(n + m)).  The order in which nodes are peeled
+// is a degeneracy order, and the degree of a node when peeled is its core
+// number:  no clique containing n has more than core[n] + 1 nodes, and n has
+// at most core[n] neighbors later in the order.  The peeling is written once
+// over a small adjacency view, so the dense Graph and Sparse_Graph share it
+// (see sparse_core_order).
+
+#ifndef _CORE_DECOMPOSITION_H
+#define _CORE_DECOMPOSITION_H 1
+
+#include <vector>
+#include "Graph.h"
+using namespace std;
+
+// Degeneracy order and core numbers of the nodes of v.  core has an entry
+// for every node of the graph (0 outside v).  O(n^2/64 + m).
+void core_order(const Graph::Vertices &v, vector<int> &order,
+                                          vector<int> &core);
+
+// Remove from mygraph every node whose core number is below
+// min_clique_size - 1, since no such node is in a clique of min_clique_size
+// nodes.  Returns the number of nodes removed.
+int Core_Preprocessor(Graph::Vertices &mygraph, int min_clique_size);
+
+// The peeling itself.  An adjacency view provides
+//   int size() const                         bound on node numbers
+//   bool alive(int n) const                  n is in the graph
+//   int degree(int n) const                  neighbors of n in the graph
+//   void nbrs(int n, vector<int> &) const    those neighbors
+template <class Adj>
+void peel(const Adj &a, vector<int> &order, vector<int> &core)
+{
+  int i, j, n, u, w, d;
+  int max_deg = 0;
+  vector<int> deg(a.size(), 0);
+  vector<int> pos(a.size(), 0);
+  vector<int> bin, nbr;
+
+  // Bucket sort the nodes by degree; bin[d] is the first position of
+  // degree d in order
+  for (n=0; n<a.size(); ++n)
+  {
+    if (!a.alive(n)) continue;
+    deg[n] = a.degree(n);
+    max_deg = max(max_deg, deg[n]);
+  }
+  bin.assign(max_deg + 2, 0);
+  for (n=0; n<a.size(); ++n) if (a.alive(n)) ++bin[deg[n] + 1];
+  for (d=1; d<=max_deg + 1; ++d) bin[d] += bin[d-1];
+  order.resize(bin[max_deg + 1]);
+  for (n=0; n<a.size(); ++n)
+  {
+    if (!a.alive(n)) continue;
+    pos[n] = bin[deg[n]]++;
+    order[pos[n]] = n;
+  }
+  for (d=max_deg; d>0; --d) bin[d] = bin[d-1];
+  bin[0] = 0;
+
+  // Peel in order; a neighbor whose degree drops moves to the front of its
+  // bucket, which then starts one place later
+  core.assign(a.size(), 0);
+  for (i=0; i<(int)order.size(); ++i)
+  {
+    n = order[i];
+    core[n] = deg[n];
+    a.nbrs(n, nbr);
+    for (j=0; j<(int)nbr.size(); ++j)
+    {
+      u = nbr[j];
+      if (deg[u] <= deg[n]) continue;
+      d = deg[u];
+      w = order[bin[d]];
+      if (u != w)
+      {
+        order[pos[u]] = w;
+        pos[w] = pos[u];
+        order[bin[d]] = u;
+        pos[u] = bin[d];
+      }
+      ++bin[d];
+      --deg[u];
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,393 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include "Edge_Loader.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Files smaller than this are parsed by a single thread
+#define LOADER_BYTES_PER_THREAD (1 << 20)
+#define LOADER_MAX_THREADS 16
+
+// Integer labels use the flat-array fast path only when the largest label
+// is at most this many times the header's node count (plus some slack), so
+// the array stays small.
+#define INT_LABEL_SPREAD 4
+#define INT_LABEL_SLACK 1024
+
+Mapped_File::Mapped_File(const string &file_name)
+:data(0), length(0), mapped(0)
+{
+#if !defined(_WIN32)
+  int fd = open(file_name.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void *p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED)
+    {
+      data = (const char *)p;
+      length = st.st_size;
+      mapped = 1;
+    }
+  }
+  if (fd >= 0) close(fd);
+  if (mapped) return;
+#endif
+
+  ifstream input(file_name.c_str(), ios::in | ios::binary);
+  if (!input)
+  {
+    cerr << "Error - Unable to open file " << file_name << endl;
+    exit(EXIT_FAILURE);
+  }
+  input.seekg(0, ios::end);
+  length = input.tellg();
+  input.seekg(0, ios::beg);
+  buffer.resize(length / sizeof(unsigned long long) + 1);
+  input.read((char *)&buffer[0], length);
+  data = (const char *)&buffer[0];
+}
+
+Mapped_File::~Mapped_File()
+{
+#if !defined(_WIN32)
+  if (mapped) munmap((void *)data, length);
+#endif
+}
+
+void Mapped_File::sequential() const
+{
+#if !defined(_WIN32) && defined(MADV_SEQUENTIAL)
+  if (mapped) madvise((void *)data, length, MADV_SEQUENTIAL);
+#endif
+}
+
+// Open-addressing hash table of labels.  Labels are (pointer, length) pairs
+// into the mapped file, so nothing is copied until the final label table is
+// built.  Ids are assigned in insertion order.
+class Label_Table
+{
+  vector<int> slots;  // -1 for empty, otherwise an id
+  vector<const char *> ptrs;
+  vector<int> lens;
+  vector<unsigned> hashes;
+  unsigned mask;
+
+  static unsigned hash(const char *p, int len)
+  {
+    unsigned h = 2166136261u;  // FNV-1a
+    for (int i=0; i<len; ++i) {h ^= (unsigned char)p[i]; h *= 16777619u;}
+    return h;
+  }
+
+  void grow()
+  {
+    int i;
+    unsigned s;
+    slots.assign(slots.size() * 2, -1);
+    mask = slots.size() - 1;
+    for (i=0; i<(int)ptrs.size(); ++i)
+    {
+      for (s = hashes[i] & mask; slots[s] != -1; s = (s + 1) & mask) ;
+      slots[s] = i;
+    }
+  }
+
+  public:
+  Label_Table() :slots(1024, -1), mask(1023) {}
+
+  int intern(const char *p, int len)
+  {
+    unsigned h = hash(p, len);
+    unsigned s;
+    int id;
+
+    for (s = h & mask; slots[s] != -1; s = (s + 1) & mask)
+    {
+      id = slots[s];
+      if (hashes[id] == h && lens[id] == len && memcmp(ptrs[id], p, len) == 0)
+                                                                   return id;
+    }
+
+    id = ptrs.size();
+    slots[s] = id;
+    ptrs.push_back(p);
+    lens.push_back(len);
+    hashes.push_back(h);
+    if (ptrs.size() * 2 > slots.size()) grow();
+    return id;
+  }
+
+  int size() const {return ptrs.size();}
+  const char *ptr(int id) const {return ptrs[id];}
+  int len(int id) const {return lens[id];}
+};
+
+// One contiguous, line-aligned piece of the file body
+struct Chunk
+{
+  const char *begin, *end;
+  bool numeric;          // Edges hold raw integer labels, not local ids
+  long max_value;        // Largest integer label (numeric mode only)
+  long malformed;
+  Label_Table labels;    // Local labels (hash mode only)
+  vector<pair<int, int> > edges;
+
+  Chunk() :begin(0), end(0), numeric(0), max_value(-1), malformed(0) {}
+};
+
+static inline bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' ||
+         c == '\f';
+}
+
+// Canonical non-negative decimal (no sign, no leading zeros) that fits in an
+// int.  Only such labels round-trip through the integer fast path.
+static inline bool parse_int_label(const char *p, int len, long &value)
+{
+  int i;
+  if (len < 1 || len > 9) return 0;
+  if (len > 1 && p[0] == '0') return 0;
+  value = 0;
+  for (i=0; i<len; ++i)
+  {
+    if (p[i] < '0' || p[i] > '9') return 0;
+    value = value * 10 + (p[i] - '0');
+  }
+  return 1;
+}
+
+// Parse one chunk.  In numeric mode, falls back to hash mode (restarting the
+// chunk) at the first label that is not a plain integer.
+static void parse_chunk(Chunk *c, bool try_numeric)
+{
+  const char *p, *line_end;
+  const char *tok[2];
+  int tok_len[2];
+  int num_tok;
+  long v1, v2;
+
+  c->numeric = try_numeric;
+  c->max_value = -1;
+  c->malformed = 0;
+  c->edges.clear();
+
+  for (p = c->begin; p < c->end; p = line_end + 1)
+  {
+    line_end = (const char *)memchr(p, '\n', c->end - p);
+    if (line_end == 0) line_end = c->end;
+
+    // Split out the first two tokens of the line
+    num_tok = 0;
+    while (p < line_end && num_tok < 2)
+    {
+      while (p < line_end && is_space(*p)) ++p;
+      if (p == line_end) break;
+      tok[num_tok] = p;
+      while (p < line_end && !is_space(*p)) ++p;
+      tok_len[num_tok] = p - tok[num_tok];
+      ++num_tok;
+    }
+    // A line without exactly two labels is counted and makes no edge
+    if (num_tok < 2)
+    {
+      if (num_tok == 1) ++c->malformed;
+      continue;
+    }
+    while (p < line_end && is_space(*p)) ++p;
+    if (p < line_end)
+    {
+      ++c->malformed;
+      continue;
+    }
+
+    if (c->numeric)
+    {
+      if (parse_int_label(tok[0], tok_len[0], v1) &&
+          parse_int_label(tok[1], tok_len[1], v2))
+      {
+        if (v1 > c->max_value) c->max_value = v1;
+        if (v2 > c->max_value) c->max_value = v2;
+        c->edges.push_back(make_pair((int)v1, (int)v2));
+        continue;
+      }
+      parse_chunk(c, 0);
+      return;
+    }
+
+    v2 = c->labels.intern(tok[1], tok_len[1]);
+    v1 = c->labels.intern(tok[0], tok_len[0]);
+    c->edges.push_back(make_pair((int)v1, (int)v2));
+  }
+}
+
+// Rewrite a hash-mode chunk's local ids as global ids
+static void remap_chunk(Chunk *c, const vector<int> *local2global)
+{
+  vector<pair<int, int> >::iterator e;
+  for (e = c->edges.begin(); e != c->edges.end(); ++e)
+  {
+    e->first = (*local2global)[e->first];
+    e->second = (*local2global)[e->second];
+  }
+}
+
+int loader_threads(double work, int num_threads)
+{
+  int max_threads = num_threads;
+
+  if (max_threads <= 0)
+  {
+    max_threads = thread::hardware_concurrency();
+    if (max_threads <= 0) max_threads = 1;
+    if (max_threads > LOADER_MAX_THREADS) max_threads = LOADER_MAX_THREADS;
+  }
+  int wanted = (int)(work / LOADER_BYTES_PER_THREAD) + 1;
+  return wanted < max_threads ? wanted : max_threads;
+}
+
+void load_edge_list(const string &graph_file, Edge_List &el, int num_threads)
+{
+  int i, t;
+  long j, k;
+  const char *p, *body;
+  Mapped_File file(graph_file);
+  file.sequential();
+
+  el.labels.clear();
+  el.edges.clear();
+  el.malformed_lines = 0;
+  el.integer_labels = 0;
+
+  // Header line
+  const char *header_end = (const char *)memchr(file.begin(), '\n',
+                                                file.end() - file.begin());
+  if (header_end == 0) header_end = file.end();
+  string header(file.begin(), header_end);
+  el.header_nodes = 0;
+  el.header_edges = 0;
+  {
+    char *first, *second;
+    el.header_nodes = strtol(header.c_str(), &first, 10);
+    el.header_edges = strtol(first, &second, 10);
+    while (*second && is_space(*second)) ++second;
+    el.header_valid = first != header.c_str() && second != first && !*second &&
+                      el.header_nodes >= 0 && el.header_edges >= 0;
+  }
+  body = (header_end < file.end()) ? header_end + 1 : file.end();
+
+  // Split the body into line-aligned chunks
+  int num_chunks = loader_threads(file.end() - body, num_threads);
+  vector<Chunk> chunks(num_chunks);
+  p = body;
+  for (i=0; i<num_chunks; ++i)
+  {
+    chunks[i].begin = p;
+    if (i == num_chunks - 1) p = file.end();
+    else
+    {
+      p = body + (file.end() - body) * (i + 1) / num_chunks;
+      if (p < chunks[i].begin) p = chunks[i].begin;
+      const char *nl = (const char *)memchr(p, '\n', file.end() - p);
+      p = nl ? nl + 1 : file.end();
+    }
+    chunks[i].end = p;
+  }
+
+  // Parse chunks in parallel, trying the integer fast path first
+  vector<thread> workers;
+  for (i=1; i<num_chunks; ++i) workers.push_back(thread(parse_chunk, &chunks[i], 1));
+  parse_chunk(&chunks[0], 1);
+  for (t=0; t<(int)workers.size(); ++t) workers[t].join();
+  workers.clear();
+
+  bool all_numeric = 1;
+  long max_value = -1;
+  for (i=0; i<num_chunks; ++i)
+  {
+    el.malformed_lines += chunks[i].malformed;
+    if (!chunks[i].numeric) all_numeric = 0;
+    else if (chunks[i].max_value > max_value) max_value = chunks[i].max_value;
+  }
+  if (max_value >= (long)max(el.header_nodes, 0) * INT_LABEL_SPREAD + INT_LABEL_SLACK)
+    all_numeric = 0;
+
+  // Integer fast path:  number labels through a flat array, in file order
+  if (all_numeric)
+  {
+    vector<int> id_of(max_value + 1, -1);
+    char buf[16];
+    el.integer_labels = 1;
+    for (i=0; i<num_chunks; ++i)
+    {
+      vector<pair<int, int> > &e = chunks[i].edges;
+      for (j=0; j<(long)e.size(); ++j)
+      {
+        int *ends[2] = {&e[j].second, &e[j].first};
+        for (k=0; k<2; ++k)
+        {
+          int &id = id_of[*ends[k]];
+          if (id < 0)
+          {
+            id = el.labels.size();
+            snprintf(buf, sizeof(buf), "%d", *ends[k]);
+            el.labels.push_back(buf);
+          }
+          *ends[k] = id;
+        }
+      }
+    }
+  }
+
+  // General path:  reparse any chunk left in numeric mode, then merge the
+  // local label tables in chunk order and remap edges in parallel
+  else
+  {
+    for (i=0; i<num_chunks; ++i)
+      if (chunks[i].numeric) workers.push_back(thread(parse_chunk, &chunks[i], 0));
+    for (t=0; t<(int)workers.size(); ++t) workers[t].join();
+    workers.clear();
+
+    Label_Table global;
+    vector<vector<int> > local2global(num_chunks);
+    for (i=0; i<num_chunks; ++i)
+    {
+      Label_Table &local = chunks[i].labels;
+      local2global[i].resize(local.size());
+      for (k=0; k<local.size(); ++k)
+      {
+        int id = global.intern(local.ptr(k), local.len(k));
+        if (id == (int)el.labels.size())
+                  el.labels.push_back(string(local.ptr(k), local.len(k)));
+        local2global[i][k] = id;
+      }
+    }
+
+    for (i=1; i<num_chunks; ++i)
+      workers.push_back(thread(remap_chunk, &chunks[i], &local2global[i]));
+    remap_chunk(&chunks[0], &local2global[0]);
+    for (t=0; t<(int)workers.size(); ++t) workers[t].join();
+  }
+
+  // Concatenate edges
+  long total = 0;
+  for (i=0; i<num_chunks; ++i) total += chunks[i].edges.size();
+  el.edges.reserve(total);
+  for (i=0; i<num_chunks; ++i)
+  {
+    el.edges.insert(el.edges.end(), chunks[i].edges.begin(),
+                                    chunks[i].edges.end());
+    vector<pair<int, int> >().swap(chunks[i].edges);
+  }
+}
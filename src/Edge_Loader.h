@@ -0,0 +1,76 @@
+// Parallel edge list loader
+// Reads an edge list file (a "<nodes> <edges>" header line followed by one
+// "<label> <label>" edge per line) in a single pass over a memory-mapped
+// copy of the file.  The body is split at line boundaries into chunks that
+// are parsed by separate threads, labels are interned per chunk and then
+// merged, and the result is handed to Graph::build or Sparse_Graph::build
+// to fill the adjacency structure in bulk.
+//
+// Node numbers are assigned in order of first appearance in the file, with
+// the second label of an edge line numbered before the first.  That is the
+// order the old token-by-token reader produced under GCC, so existing
+// results are unchanged, and it does not depend on the number of threads.
+// When every label is a plain decimal integer the hash tables are skipped
+// entirely and labels are mapped through a flat array.
+
+#ifndef _EDGE_LOADER_H
+#define _EDGE_LOADER_H 1
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+using namespace std;
+
+// Read-only view of a whole file.  Uses mmap where available and otherwise
+// reads the file into (8-byte aligned) memory.  Exits if the file cannot be
+// opened.
+class Mapped_File
+{
+  const char *data;
+  size_t length;
+  bool mapped;
+  vector<unsigned long long> buffer;
+
+  public:
+  Mapped_File(const string &file_name);
+  ~Mapped_File();
+
+  const char *begin() const {return data;}
+  const char *end() const {return data + length;}
+  size_t size() const {return length;}
+
+  // Hint that the file will be read front to back
+  void sequential() const;
+
+  private:
+  Mapped_File(const Mapped_File &);
+  Mapped_File &operator=(const Mapped_File &);
+};
+
+struct Edge_List
+{
+  int header_nodes;   // Values from the header line
+  long header_edges;
+  bool header_valid;  // Header line holds exactly two non-negative integers
+  vector<string> labels;          // Node number to label, first-appearance
+  vector<pair<int, int> > edges;  // Edges in file order (may repeat)
+  long malformed_lines;           // Non-empty lines without exactly two
+                                  // labels (these make no edges)
+  bool integer_labels;            // Integer fast path was used
+
+  Edge_List()
+  :header_nodes(0), header_edges(0), header_valid(0), malformed_lines(0),
+   integer_labels(0) {}
+};
+
+// Load graph_file into el.  num_threads <= 0 picks a default based on the
+// hardware and the file size.
+void load_edge_list(const string &graph_file, Edge_List &el,
+                                              int num_threads = 0);
+
+// Number of worker threads to use for a job of the given size (in bytes
+// or items); small jobs get one thread.
+int loader_threads(double work, int num_threads = 0);
+
+#endif
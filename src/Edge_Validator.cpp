@@ -0,0 +1,165 @@
+#include <Rcpp.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <unordered_set>
+#include "Edge_Validator.h"
+#include "Graph_Handle.h"
+
+// Unordered pair of node numbers as a single hash key
+static inline unsigned long long edge_key(int a, int b)
+{
+  if (a > b) swap(a, b);
+  return (unsigned long long)(unsigned)a << 32 | (unsigned)b;
+}
+
+bool check_edge_list(Edge_List &el, Edge_List_Check &check, bool repair)
+{
+  long i, kept = 0;
+  pair<int, int> first_loop, first_duplicate;
+  int n = el.labels.size();
+  long m = el.edges.size();
+  unordered_set<unsigned long long> seen;
+  ostringstream msg;
+
+  check = Edge_List_Check();
+  seen.reserve(m);
+  for (i=0; i<m; ++i)
+  {
+    const pair<int, int> &e = el.edges[i];
+    if (e.first == e.second)
+    {
+      if (check.self_loops++ == 0) first_loop = e;
+      continue;
+    }
+    if (!seen.insert(edge_key(e.first, e.second)).second)
+    {
+      if (check.duplicate_edges++ == 0) first_duplicate = e;
+      continue;
+    }
+    if (repair) el.edges[kept] = e;
+    ++kept;
+  }
+  check.edges = kept;
+
+  // Same checks, in the same order, as the old R formatter
+  if (!el.header_valid)
+    check.problems.push_back("first line should hold the number of vertices and edges");
+  if (el.malformed_lines > 0)
+  {
+    msg.str("");
+    msg << el.malformed_lines << " line(s) do not have exactly two vertex labels";
+    check.problems.push_back(msg.str());
+  }
+  if (m == 0) check.problems.push_back("has no edges");
+  if (el.header_valid && el.header_edges != m)
+  {
+    msg.str("");
+    msg << "heading doesn't match number of edges: " << el.header_edges << " " << m;
+    check.problems.push_back(msg.str());
+  }
+  if (check.duplicate_edges > 0)
+  {
+    msg.str("");
+    msg << "has " << check.duplicate_edges << " duplicated edge(s), first: "
+        << el.labels[first_duplicate.first] << " "
+        << el.labels[first_duplicate.second];
+    check.problems.push_back(msg.str());
+  }
+  if (check.self_loops > 0)
+  {
+    msg.str("");
+    msg << "has " << check.self_loops << " edge(s) between the same vertex, first: "
+        << el.labels[first_loop.first] << " " << el.labels[first_loop.second];
+    check.problems.push_back(msg.str());
+  }
+  if (el.header_valid && el.header_nodes != n)
+  {
+    msg.str("");
+    msg << "heading doesn't match number of vertices: " << el.header_nodes << " " << n;
+    check.problems.push_back(msg.str());
+  }
+
+  if (repair)
+  {
+    // Drop vertices that only had self loops, keeping the others in order
+    vector<int> new_id(n, -1);
+    int used = 0;
+    el.edges.resize(kept);
+    for (i=0; i<kept; ++i) new_id[el.edges[i].first] = new_id[el.edges[i].second] = 0;
+    for (i=0; i<n; ++i)
+      if (new_id[i] == 0)
+      {
+        new_id[i] = used;
+        el.labels[used++].swap(el.labels[i]);
+      }
+    el.labels.resize(used);
+    for (i=0; i<kept; ++i)
+    {
+      el.edges[i].first = new_id[el.edges[i].first];
+      el.edges[i].second = new_id[el.edges[i].second];
+    }
+    n = used;
+    el.header_nodes = n;
+    el.header_edges = kept;
+    el.header_valid = 1;
+    el.malformed_lines = 0;
+  }
+  return check.problems.empty();
+}
+
+void write_edge_list(const Edge_List &el, const string &graph_file)
+{
+  long i;
+  ofstream out(graph_file.c_str(), ios::out | ios::trunc);
+
+  if (!out)
+  {
+    cerr << "Error - Unable to open file " << graph_file << endl;
+    exit(EXIT_FAILURE);
+  }
+  out << el.labels.size() << "\t" << el.edges.size() << "\n";
+  for (i=0; i<(long)el.edges.size(); ++i)
+    out << el.labels[el.edges[i].first] << "\t"
+        << el.labels[el.edges[i].second] << "\n";
+  out.close();
+  if (!out)
+  {
+    cerr << "Error - Unable to write file " << graph_file << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// Load and check an edge list file in one pass.  With repair, problems are
+// fixed (and the result written to repaired, unless it is empty) rather
+// than rejected.  With load, the graph is returned as a handle if it is
+// valid or was repaired.
+// [[Rcpp::export]]
+Rcpp::List check_graph_file(std::string filename, bool repair,
+                            std::string repaired, bool load)
+{
+  Edge_List el;
+  Edge_List_Check check;
+  Rcpp::RObject graph;
+
+  load_edge_list(filename, el);
+  int header_nodes = el.header_nodes;
+  double header_edges = el.header_edges, malformed = el.malformed_lines;
+  bool valid = check_edge_list(el, check, repair);
+  if (repair && !repaired.empty()) write_edge_list(el, repaired);
+  if (load && (valid || repair))
+    graph = Rcpp::XPtr<Graph_Handle>(new Graph_Handle(el, filename), true);
+
+  return Rcpp::List::create(
+    Rcpp::Named("valid") = valid,
+    Rcpp::Named("problems") = check.problems,
+    Rcpp::Named("vertices") = (int)el.labels.size(),
+    Rcpp::Named("edges") = (double)check.edges,
+    Rcpp::Named("header_vertices") = header_nodes,
+    Rcpp::Named("header_edges") = header_edges,
+    Rcpp::Named("self_loops") = (double)check.self_loops,
+    Rcpp::Named("duplicate_edges") = (double)check.duplicate_edges,
+    Rcpp::Named("malformed_lines") = malformed,
+    Rcpp::Named("graph") = graph);
+}
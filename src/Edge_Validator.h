@@ -0,0 +1,37 @@
+// Edge list validation
+// Checks a loaded Edge_List against the rules of the cliqueR file format:
+// a header line holding the number of vertices and edges, then exactly two
+// labels per line, with no self loops, no repeated edges (in either
+// direction) and counts that agree with the header.  The check runs over
+// the edge list produced by load_edge_list, so a file is parsed once for
+// both validation and graph construction.  Repeated edges are found with a
+// hash set keyed on the unordered pair of node numbers.
+
+#ifndef _EDGE_VALIDATOR_H
+#define _EDGE_VALIDATOR_H 1
+
+#include <string>
+#include <vector>
+#include "Edge_Loader.h"
+using namespace std;
+
+struct Edge_List_Check
+{
+  long edges;            // Distinct edges, excluding self loops
+  long self_loops;       // Lines joining a vertex to itself
+  long duplicate_edges;  // Lines repeating an earlier edge
+  vector<string> problems;  // One message per kind of problem found
+
+  Edge_List_Check() :edges(0), self_loops(0), duplicate_edges(0) {}
+};
+
+// Check el, filling check.  Returns true if no problems were found.  With
+// repair, self loops and repeated edges are also removed from el and the
+// header counts are set to match what remains; check still describes the
+// edge list as it was loaded.
+bool check_edge_list(Edge_List &el, Edge_List_Check &check, bool repair = 0);
+
+// Write el as an edge list file
+void write_edge_list(const Edge_List &el, const string &graph_file);
+
+#endif
@@ -0,0 +1,127 @@
+// Fixed-capacity bit sets for small and medium graphs
+// fixed_bitset<N> holds N bits (a multiple of the word size) in inline
+// storage, laid out like bitarray (most significant bit first in each word)
+// so that graph rows can be copied into one word for word.  There is no
+// heap storage and no size fields, and every loop runs over a constant
+// number of words, so the compiler can unroll and vectorize it.  Counting
+// goes through the runtime-selected bit kernels, so that it uses POPCNT
+// where the CPU has it.
+
+#ifndef _FIXED_BITSET_H
+#define _FIXED_BITSET_H 1
+
+#include "Bitarray.h"
+#include "bit_kernels.h"
+
+template <int N>
+class fixed_bitset
+{
+  public:
+  enum {WORDS = N / NUM_ULBITS};
+
+  private:
+  unsigned long w[WORDS];
+
+  public:
+  // Contents are left undefined, as for a plain array
+  fixed_bitset() {}
+
+  // Copy in the first n words of src (n <= WORDS) and clear the rest
+  void load(const unsigned long *src, int n)
+  {
+    int i;
+    for (i=0; i<n; ++i) w[i] = src[i];
+    for (; i<WORDS; ++i) w[i] = 0;
+  }
+
+  const unsigned long *words() const {return w;}
+
+  void reset()
+  {
+    int i;
+    for (i=0; i<WORDS; ++i) w[i] = 0;
+  }
+
+  bool test(int b) const
+          {return (w[BIT2UL(b)] >> (NUM_ULBITS - 1 - BIT2ULPOS(b))) & 1UL;}
+  void set(int b) {w[BIT2UL(b)] |= 1UL << (NUM_ULBITS - 1 - BIT2ULPOS(b));}
+  void reset(int b)
+               {w[BIT2UL(b)] &= ~(1UL << (NUM_ULBITS - 1 - BIT2ULPOS(b)));}
+
+  int count() const {return bit_kernels.count(w, WORDS);}
+  bool empty() const
+  {
+    int i;
+    unsigned long any = 0;
+    for (i=0; i<WORDS; ++i) any |= w[i];
+    return any == 0;
+  }
+
+  // Exactly one bit set
+  bool single() const
+  {
+    int i;
+    for (i=0; i<WORDS && w[i] == 0; ++i) ;
+    if (i == WORDS || (w[i] & (w[i] - 1)) != 0) return 0;
+    for (++i; i<WORDS; ++i) if (w[i] != 0) return 0;
+    return 1;
+  }
+
+  // Lowest numbered bit set, or -1 if none
+  int first() const
+  {
+    int i;
+    for (i=0; i<WORDS; ++i)
+      if (w[i] != 0) return i * NUM_ULBITS + __builtin_clzl(w[i]);
+    return -1;
+  }
+
+  fixed_bitset &operator&=(const fixed_bitset &b)
+  {
+    int i;
+    for (i=0; i<WORDS; ++i) w[i] &= b.w[i];
+    return *this;
+  }
+
+  fixed_bitset &operator|=(const fixed_bitset &b)
+  {
+    int i;
+    for (i=0; i<WORDS; ++i) w[i] |= b.w[i];
+    return *this;
+  }
+
+  // *this &= ~b
+  fixed_bitset &andnot(const fixed_bitset &b)
+  {
+    int i;
+    for (i=0; i<WORDS; ++i) w[i] &= ~b.w[i];
+    return *this;
+  }
+
+  // *this = a & b, in one pass
+  void assign_and(const fixed_bitset &a, const fixed_bitset &b)
+  {
+    int i;
+    for (i=0; i<WORDS; ++i) w[i] = a.w[i] & b.w[i];
+  }
+
+  // (*this & a) is a subset of super; stops at the first word that is not
+  bool and_subset(const fixed_bitset &a, const fixed_bitset &super) const
+  {
+    int i;
+    for (i=0; i<WORDS; ++i) if (w[i] & a.w[i] & ~super.w[i]) return 0;
+    return 1;
+  }
+
+  // In-place andnot over the words from word "from" on only
+  void andnot_from(const fixed_bitset &b, int from)
+  {
+    int i;
+    for (i=from; i<WORDS; ++i) w[i] &= ~b.w[i];
+  }
+
+  unsigned long word(int i) const {return w[i];}
+  void clear_word_bit(int i, int b) {w[i] &= ~(1UL << (NUM_ULBITS - 1 - b));}
+};
+
+#endif
@@ -0,0 +1,416 @@
+// Branching on fixed-capacity bit sets
+// The search of Static_Brancher<Sat_Color_Man, 1, Bound> (best to worst,
+// word-parallel coloring tightened by MaxSAT reasoning) for graphs whose
+// nodes are numbered below N.  The adjacency rows are copied into
+// fixed_bitset<N>s, candidate sets and cliques live on the call stack, and
+// coloring and propagation work on whole sets with a constant word count.
+// Visits the same search tree and returns the same clique as
+// Static_Brancher with the same dominance setting.  find_mc picks the
+// smallest N that fits the shrunken graph (see branch_fixed).
+//
+// Subproblems shrink quickly with depth, while the sets stay N bits wide.
+// Once a candidate set has at most N/4 nodes and is not close to being
+// pruned, it is renumbered (keeping the node order, so the search is
+// unchanged) to a compact local index space and searched there by a
+// narrower engine, whose result is mapped back; this is Graph::shrink done
+// online.  The narrower engine is kept and reused, so renumbering allocates
+// nothing after warm up.
+
+#ifndef _FIXED_BRANCHER_H
+#define _FIXED_BRANCHER_H 1
+
+#include <vector>
+#include "Graph.h"
+#include "Fixed_Bitset.h"
+#include "Static_Brancher.h"
+using namespace std;
+
+// Subproblems of at most N/4 nodes are renumbered (see above) when their
+// coloring bound beats the best clique by at least FIXED_REINDEX_SLACK:
+// tighter subproblems are pruned too fast to pay for the copy
+#define FIXED_REINDEX_MIN 256
+#define FIXED_REINDEX_SLACK 4
+
+template <int N, class Bound = Own_Bound>
+class Fixed_Brancher
+{
+  typedef fixed_bitset<N> Set;
+  template <int M, class B> friend class Fixed_Brancher;
+
+  // Width of the engine for renumbered subproblems (N itself when too
+  // narrow to renumber)
+  enum {SUB_N = N >= FIXED_REINDEX_MIN ? N / 4 : N};
+  typedef Fixed_Brancher<SUB_N, Bound> Sub_Brancher;
+
+  // Candidates of one depth in ascending color order, as in Sat_Color_Man
+  struct Level
+  {
+    vector<int> cands;
+    vector<int> colors;
+    vector<char> pruned;
+  };
+
+  Bound bound;
+  bool dominance;
+  Search_Stats stats;
+  vector<Set> rows;
+  Set best;
+  int best_size;
+  vector<Level> levels;
+
+  // Coloring and propagation state, used by one depth at a time
+  vector<Set> classes;
+  vector<Set> live;
+  vector<char> used;
+  vector<int> open;
+  vector<int> lits;
+  vector<int> lit_class;
+  vector<char> needed;
+
+  // Renumbering state
+  Sub_Brancher *sub;
+  vector<int> sub_nodes;  // Node of each local index, ascending
+  vector<int> local_id;   // Local index of each node, or -1
+  vector<int> sub_words;  // Nonzero words of the renumbered set
+
+  public:
+  Fixed_Brancher(const Bound &b = Bound())
+  :bound(b), dominance(0), best_size(0), sub(0) {}
+  ~Fixed_Brancher() {delete sub;}
+
+  // As in Static_Brancher
+  void set_dominance(bool d) {dominance = d;}
+
+  // Same as Brancher::operator(); g->max_size() must be at most N
+  int operator() (Graph &g, Graph::Vertices &maximum_clique);
+
+  private:
+  void expand(int depth, Set &mygraph, const Set &clique, int clique_size);
+  void expand_local(const Set &mygraph, const Set &clique, int clique_size);
+  template <class R>
+  void search_sub(const vector<R> &parent_rows, const R &within,
+              const vector<int> &nodes, const vector<int> &node2local,
+              const vector<int> &words, int clique_size, int best_so_far);
+  int remove_dominated(Set &s, int d);
+  int color(const Set &s, Level &l);
+  void sat_prune(int k, Level &l);
+  bool inconsistent(int node, int num_prefix);
+  void mark_reasons(int c, int skip, int num_lits);
+
+  Fixed_Brancher(const Fixed_Brancher &);
+  Fixed_Brancher &operator=(const Fixed_Brancher &);
+};
+
+template <int N, class Bound>
+int Fixed_Brancher<N, Bound>::operator() (Graph &g,
+                                          Graph::Vertices &maximum_clique)
+{
+  int i;
+  int n = g.max_size();
+  int nw = min((int)Set::WORDS, g.row_words());
+  Graph::Vertices v(g);
+  Set all, clique;
+
+  if (n > N)
+  {
+    cerr << "Error - graph too large for Fixed_Brancher." << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  rows.resize(n);
+  for (i=0; i<n; ++i) rows[i].load(g.row(i), nw);
+  v.fill();
+  all.load(v.words(), v.num_words());
+  best.load(maximum_clique.words(), maximum_clique.num_words());
+  best_size = maximum_clique.size();
+
+  // One level per clique node
+  levels.resize(n + 2);
+  clique.reset();
+  expand(0, all, clique, 0);
+  report_search_stats(stats);
+
+  if (best_size > maximum_clique.size())
+  {
+    maximum_clique.clear();
+    for (i=0; i<n; ++i) if (best.test(i)) maximum_clique.insert(i);
+  }
+  return maximum_clique.size();
+}
+
+template <int N, class Bound>
+void Fixed_Brancher<N, Bound>::expand(int depth, Set &mygraph,
+                                      const Set &clique, int clique_size)
+{
+  int k, cand, next_cand;
+  Level &l = levels[depth];
+  Set tmpgraph, tmpclique;
+
+  ++stats.branches;
+  if (bound.done(best_size)) return;
+
+  // Renumber a subproblem that is narrow enough and far from pruned
+  k = color(mygraph, l);
+  if (k + clique_size < bound(best_size) + 1) return;
+  if (SUB_N < N && (int)l.cands.size() <= SUB_N &&
+      k + clique_size >= bound(best_size) + 1 + FIXED_REINDEX_SLACK)
+  {
+    expand_local(mygraph, clique, clique_size);
+    return;
+  }
+  sat_prune(bound(best_size) + 1 - clique_size, l);
+
+  next_cand = l.cands.size();
+  while (next_cand > 0)
+  {
+    --next_cand;
+    if (clique_size + l.colors[next_cand] < bound(best_size) + 1) break;
+    if (l.pruned[next_cand]) continue;
+    cand = l.cands[next_cand];
+    if (!mygraph.test(cand)) continue;
+
+    // Assume cand is in clique
+    tmpclique = clique;
+    tmpclique.set(cand);
+    if (clique_size + 1 > best_size)
+    {
+      best = tmpclique;
+      best_size = clique_size + 1;
+    }
+    tmpgraph.assign_and(mygraph, rows[cand]);
+    expand(depth + 1, tmpgraph, tmpclique, clique_size + 1);
+
+    // Assume cand is not in clique
+    mygraph.reset(cand);
+    if (dominance) stats.dominated += remove_dominated(mygraph, cand);
+
+    // Simple search tree pruning
+    if (mygraph.count() + clique_size <= bound(best_size)) break;
+    if (bound.done(best_size)) break;
+  }
+}
+
+// Search mygraph, which has at most SUB_N nodes, with the narrower engine
+template <int N, class Bound>
+void Fixed_Brancher<N, Bound>::expand_local(const Set &mygraph,
+                                            const Set &clique, int clique_size)
+{
+  int i, w, b;
+  unsigned long word;
+
+  sub_nodes.clear();
+  sub_words.clear();
+  for (w=0; w<Set::WORDS; ++w)
+  {
+    if (mygraph.word(w)) sub_words.push_back(w);
+    for (word = mygraph.word(w); word; word &= ~(1UL << (NUM_ULBITS - 1 - b)))
+    {
+      b = __builtin_clzl(word);
+      sub_nodes.push_back(w * NUM_ULBITS + b);
+    }
+  }
+  if (local_id.size() < rows.size()) local_id.resize(rows.size(), -1);
+  for (i=0; i<(int)sub_nodes.size(); ++i) local_id[sub_nodes[i]] = i;
+
+  if (!sub) sub = new Sub_Brancher(bound);
+  sub->dominance = dominance;
+  sub->search_sub(rows, mygraph, sub_nodes, local_id, sub_words, clique_size,
+                                                                best_size);
+  for (i=0; i<(int)sub_nodes.size(); ++i) local_id[sub_nodes[i]] = -1;
+  stats.add(sub->stats);
+  sub->stats = Search_Stats();
+
+  // Map a better clique back
+  if (sub->best_size > best_size)
+  {
+    best = clique;
+    for (i=0; i<(int)sub_nodes.size(); ++i)
+                          if (sub->best.test(i)) best.set(sub_nodes[i]);
+    best_size = sub->best_size;
+  }
+}
+
+// Search the subgraph induced by nodes (ascending) of the graph with
+// adjacency parent_rows, whose node set is within (nonzero in words only),
+// for cliques that beat best_so_far together with clique_size other nodes.
+// A better clique found is left in best, in local numbering.
+template <int N, class Bound>
+template <class R>
+void Fixed_Brancher<N, Bound>::search_sub(const vector<R> &parent_rows,
+         const R &within, const vector<int> &nodes,
+         const vector<int> &node2local, const vector<int> &words,
+         int clique_size, int best_so_far)
+{
+  int i, j, w, n = nodes.size();
+  unsigned long word;
+  Set all, clique;
+
+  if ((int)rows.size() < n) rows.resize(n);
+  all.reset();
+  for (i=0; i<n; ++i)
+  {
+    all.set(i);
+    rows[i].reset();
+    for (j=0; j<(int)words.size(); ++j)
+    {
+      w = words[j];
+      word = parent_rows[nodes[i]].word(w) & within.word(w);
+      for (; word; word &= word - 1)
+        rows[i].set(node2local[w * NUM_ULBITS + NUM_ULBITS - 1 -
+                                                 __builtin_ctzl(word)]);
+    }
+  }
+
+  best_size = best_so_far;
+  if ((int)levels.size() < n + 2) levels.resize(n + 2);
+  clique.reset();
+  expand(0, all, clique, clique_size);
+}
+
+// Graph::Vertices::remove_dominated on fixed sets
+template <int N, class Bound>
+int Fixed_Brancher<N, Bound>::remove_dominated(Set &s, int d)
+{
+  int i, b, num_removed = 0;
+  unsigned long word;
+
+  for (i=0; i<Set::WORDS; ++i)
+  {
+    for (word = s.word(i) & rows[d].word(i); word;
+                              word &= ~(1UL << (NUM_ULBITS - 1 - b)))
+    {
+      b = __builtin_clzl(word);
+      if (!s.and_subset(rows[i * NUM_ULBITS + b], rows[d])) continue;
+      s.clear_word_bit(i, b);
+      ++num_removed;
+    }
+  }
+
+  return num_removed;
+}
+
+// Bitset_Coloring::color on fixed sets
+template <int N, class Bound>
+int Fixed_Brancher<N, Bound>::color(const Set &s, Level &l)
+{
+  int i, w, b, node, k = 0;
+  Set uncolored(s), choices;
+
+  l.cands.clear();
+  l.colors.clear();
+  for (w=0; w<Set::WORDS; )
+  {
+    if (uncolored.word(w) == 0) {++w; continue;}
+
+    // Build one color class from the uncolored nodes
+    ++k;
+    if ((int)classes.size() < k) classes.resize(k);
+    Set &cl = classes[k-1];
+    cl.reset();
+    choices = uncolored;
+    for (i=w; i<Set::WORDS; ++i)
+    {
+      while (choices.word(i))
+      {
+        b = __builtin_clzl(choices.word(i));
+        node = i * NUM_ULBITS + b;
+        uncolored.clear_word_bit(i, b);
+        choices.clear_word_bit(i, b);
+        cl.set(node);
+        choices.andnot_from(rows[node], i);
+        l.cands.push_back(node);
+        l.colors.push_back(k);
+      }
+    }
+  }
+
+  return k;
+}
+
+// Bitset_Coloring::sat_prune on fixed sets
+template <int N, class Bound>
+void Fixed_Brancher<N, Bound>::sat_prune(int k, Level &l)
+{
+  int i;
+  int first = lower_bound(l.colors.begin(), l.colors.end(), k) -
+                                                          l.colors.begin();
+
+  l.pruned.assign(l.cands.size(), 0);
+  if (k <= 1) return;
+
+  used.assign(k - 1, 0);
+  if ((int)live.size() < k - 1) live.resize(k - 1);
+  for (i=first; i<(int)l.cands.size(); ++i)
+                         if (inconsistent(l.cands[i], k - 1)) l.pruned[i] = 1;
+}
+
+template <int N, class Bound>
+bool Fixed_Brancher<N, Bound>::inconsistent(int node, int num_prefix)
+{
+  int i, c, u, unit, conflict = -1;
+
+  open.clear();
+  for (c=0; c<num_prefix; ++c)
+  {
+    if (used[c]) continue;
+    open.push_back(c);
+    live[c].assign_and(classes[c], rows[node]);
+  }
+  lits.assign(1, node);
+  lit_class.assign(1, -1);
+
+  while (conflict == -1)
+  {
+    // Look for an emptied class, or else a class with one node left
+    unit = -1;
+    for (i=0; i<(int)open.size(); ++i)
+    {
+      if (live[open[i]].empty())
+      {
+        conflict = open[i];
+        break;
+      }
+      if (unit == -1 && live[open[i]].single()) unit = i;
+    }
+    if (conflict != -1) break;
+    if (unit == -1) return 0;
+
+    // Its last node is forced into the clique
+    c = open[unit];
+    open[unit] = open.back();
+    open.pop_back();
+    u = live[c].first();
+    lits.push_back(u);
+    lit_class.push_back(c);
+    for (i=0; i<(int)open.size(); ++i) live[open[i]] &= rows[u];
+  }
+
+  needed.assign(lits.size(), 0);
+  mark_reasons(conflict, -1, lits.size());
+  for (i=lits.size()-1; i>0; --i)
+    if (needed[i]) mark_reasons(lit_class[i], lits[i], i);
+
+  used[conflict] = 1;
+  for (i=1; i<(int)lits.size(); ++i) if (needed[i]) used[lit_class[i]] = 1;
+  return 1;
+}
+
+template <int N, class Bound>
+void Fixed_Brancher<N, Bound>::mark_reasons(int c, int skip, int num_lits)
+{
+  int i, j, x;
+  unsigned long word;
+
+  for (i=0; i<Set::WORDS; ++i)
+  {
+    for (word = classes[c].word(i); word; word &= word - 1)
+    {
+      x = i * NUM_ULBITS + NUM_ULBITS - 1 - __builtin_ctzl(word);
+      if (x == skip) continue;
+      for (j=0; j<num_lits && rows[lits[j]].test(x); ++j) ;
+      if (j < num_lits) needed[j] = 1;
+    }
+  }
+}
+
+#endif
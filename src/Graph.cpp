@@ -1,4 +1,91 @@
 #include "Graph.h"
+#include "Edge_Loader.h"
+#include "Snapshot.h"
+#include <cstdlib>
+#include <thread>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+// Alignment of the adjacency matrix.  Rows are padded to whole cache lines;
+// matrices of at least HUGE_PAGE_SIZE bytes are aligned to a huge page so
+// the kernel can back them with transparent huge pages.
+#define CACHE_LINE_SIZE 64
+#define HUGE_PAGE_SIZE (2 << 20)
+
+bool Graph::huge_pages = 1;
+
+static void *aligned_block(size_t bytes, size_t alignment)
+{
+  void *p;
+#if defined(_WIN32)
+  p = _aligned_malloc(bytes, alignment);
+#else
+  if (posix_memalign(&p, alignment, bytes) != 0) p = 0;
+#endif
+  if (p == 0)
+  {
+    cerr << "Error - unable to allocate " << bytes << " bytes for Graph." << endl;
+    exit(EXIT_FAILURE);
+  }
+  return p;
+}
+
+static void free_aligned_block(void *p)
+{
+#if defined(_WIN32)
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+int Graph::row_words_for(int n)
+{
+  const int uls_per_line = CACHE_LINE_SIZE / sizeof(unsigned long);
+  return (bitarray::words_for(n) + uls_per_line - 1) / uls_per_line * uls_per_line;
+}
+
+// Allocate a zeroed n x n matrix and point edges[0..n) at its rows.  If rows
+// is given, it is a mapped snapshot matrix (see Snapshot::map_dense_rows)
+// that is used as is.
+void Graph::alloc_matrix(int n, unsigned long *rows)
+{
+  int i;
+  size_t alignment = CACHE_LINE_SIZE;
+
+  row_uls = row_words_for(n);
+  matrix_bytes = (size_t)row_uls * sizeof(unsigned long) * n;
+  matrix_mapped = (rows != 0);
+  if (rows) matrix = rows;
+  else
+  {
+    if (huge_pages && matrix_bytes >= HUGE_PAGE_SIZE) alignment = HUGE_PAGE_SIZE;
+
+    matrix = (unsigned long *)aligned_block(matrix_bytes, alignment);
+#if defined(MADV_HUGEPAGE)
+    if (alignment == HUGE_PAGE_SIZE) madvise(matrix, matrix_bytes, MADV_HUGEPAGE);
+#endif
+    memset(matrix, 0, matrix_bytes);
+  }
+
+  edges = new bitarray[n];
+  for (i=0; i<n; i++) edges[i].attach(matrix + (size_t)i * row_uls, n);
+}
+
+static void release_matrix(unsigned long *matrix, size_t bytes, bool mapped)
+{
+  if (mapped) Snapshot::unmap_dense_rows(matrix, bytes);
+  else free_aligned_block(matrix);
+}
+
+void Graph::free_matrix()
+{
+  delete [] edges;
+  release_matrix(matrix, matrix_bytes, matrix_mapped);
+  edges = 0;
+  matrix = 0;
+}
 
 // Construct graph without a file.  Create an edgeless graph with init_size
 // nodes and capacity max_size.
@@ -9,27 +96,37 @@ Graph::Graph(int init_size, int max_size) {init(init_size, max_size);}
 // second argument (which must be >= to the size of the input graph).
 Graph::Graph(string &graph_file, int max_size)
 {
+  // Snapshots need no parsing, and their matrix is mapped rather than built
+  // whenever the capacity matches
+  if (is_snapshot(graph_file))
+  {
+    Snapshot snap(graph_file);
+    unsigned long *rows = 0;
+
+    if (max_size < 1) max_size = max(1, snap.size());
+    if (max_size == snap.size())
+                           rows = snap.map_dense_rows(row_words_for(max_size));
+    init(0, max_size, rows);
+    load_snapshot(snap, rows != 0);
+    return;
+  }
+
+  Edge_List el;
+  load_edge_list(graph_file, el);
+
   // Read maximum number of nodes from file, if not passed by the user
   if (max_size < 1)
   {
-    ifstream input(graph_file.c_str());
-    if (!input)
-    {
-      cerr << "Error - Unable to open file " << graph_file << endl;
-      exit(EXIT_FAILURE);
-    }
-    input >> max_size;
+    max_size = el.header_nodes;
     if (max_size < 1)
     {
       cerr << "Error - invalid value for number of nodes on first line of file " << graph_file << endl;
-      input.close();
       exit(EXIT_FAILURE);
     }
-    input.close();
   }
 
   init(0, max_size);
-  read_file(*this, graph_file);
+  build(el);
 }
 
 // Copy Constructor
@@ -38,37 +135,40 @@ Graph::Graph(const Graph &g)
  num_edges(g.num_edges),
  node_order(g.node_order),
  max_nodes(g.max_nodes),
- edges(new bitarray[g.max_nodes]),
  used_nodes(g.used_nodes),
+ free_hint(g.free_hint),
+ degrees(g.degrees),
  nodes(g.nodes),
  node2num(g.node2num)
 {
-  int i;
-  for (i=0; i<max_nodes; i++) edges[i] = g.edges[i];
+  alloc_matrix(max_nodes);
+  memcpy(matrix, g.matrix, matrix_bytes);
 }
 
 // Assignment Operator
 Graph &Graph::operator=(const Graph &g)
 {
-  int i;
+  if (this == &g) return *this;
 
   num_nodes = g.num_nodes;
   num_edges = g.num_edges;
   node_order = g.node_order;
   max_nodes = g.max_nodes;
   used_nodes = g.used_nodes;
+  free_hint = g.free_hint;
+  degrees = g.degrees;
   nodes = g.nodes;
   node2num = g.node2num;
 
-  delete [] edges;
-  edges = new bitarray[g.max_nodes];
-  for (i=0; i<max_nodes; i++) edges[i] = g.edges[i];
+  free_matrix();
+  alloc_matrix(max_nodes);
+  memcpy(matrix, g.matrix, matrix_bytes);
 
   return *this;
 }
 
 // Function that really constructs the graph
-void Graph::init(int init_size, int max_size)
+void Graph::init(int init_size, int max_size, unsigned long *rows)
 {
   int i;
 
@@ -85,10 +185,11 @@ void Graph::init(int init_size, int max_size)
 
   max_nodes = max_size;
 
-  edges = new bitarray[max_size];
-  for (i=0; i<max_size; i++) edges[i].create(max_size);
+  alloc_matrix(max_size, rows);
   used_nodes.create(max_size);
   for (i=0; i<init_size; i++) used_nodes.set(i);
+  free_hint = init_size;
+  degrees.assign(max_size, 0);
 
   nodes.resize(max_size);
   node2num.clear();
@@ -99,28 +200,116 @@ void Graph::init(int init_size, int max_size)
 // Note:  Any previous graph data is ERASED!
 void read_file(Graph &g, const string &graph_file)
 {
-  string node1, node2;
+  if (is_snapshot(graph_file))
+  {
+    Snapshot snap(graph_file);
+    g.build(snap);
+    return;
+  }
 
-  ifstream input(graph_file.c_str());
-  if (!input)
+  Edge_List el;
+  load_edge_list(graph_file, el);
+  g.build(el);
+}
+
+// Set the bits of rows [first, last) for every edge touching them
+static void fill_rows(bitarray *edges, const Edge_List *el, int first,
+                                                             int last)
+{
+  vector<pair<int, int> >::const_iterator e;
+  for (e = el->edges.begin(); e != el->edges.end(); ++e)
   {
-    cerr << "Error - Unable to open file " << graph_file << endl;
+    if (e->first == e->second) continue;
+    if (e->first >= first && e->first < last) edges[e->first].set(e->second);
+    if (e->second >= first && e->second < last) edges[e->second].set(e->first);
+  }
+}
+
+void Graph::build(const Edge_List &el, int num_threads)
+{
+  int i, t;
+  long deg_sum = 0;
+  int n = el.labels.size();
+
+  clear();
+  if (n > max_nodes)
+  {
+    cerr << "Error - cannot create new node in Graph - capacity exceeded." << endl;
     exit(EXIT_FAILURE);
   }
 
-  g.clear();
+  for (i=0; i<n; i++)
+  {
+    node_order.push_back(i);
+    used_nodes.set(i);
+    nodes[i] = el.labels[i];
+    if (nodes[i] != "") node2num[nodes[i]] = i;
+  }
+  num_nodes = n;
+  free_hint = n;
+
+  // Each thread owns a band of rows, so no two threads write the same word
+  int num_bands = loader_threads((double)el.edges.size() * 16, num_threads);
+  if (num_bands > n) num_bands = max(1, n);
+  vector<thread> workers;
+  for (t=1; t<num_bands; t++)
+    workers.push_back(thread(fill_rows, edges, &el,
+                        (int)((long)n * t / num_bands),
+                        (int)((long)n * (t + 1) / num_bands)));
+  fill_rows(edges, &el, 0, (int)((long)n / num_bands));
+  for (t=0; t<(int)workers.size(); t++) workers[t].join();
+
+  for (i=0; i<n; i++)
+  {
+    degrees[i] = edges[i].count();
+    deg_sum += degrees[i];
+  }
+  num_edges = deg_sum / 2;
+}
+
+void Graph::build(const Snapshot &snap)
+{
+  clear();
+  load_snapshot(snap, 0);
+}
 
-  // MAIN LOOP
-  input >> node1 >> node2;  // Skip header
-  input >> node1 >> node2;
-  while(input)
+// Fill an empty graph from a snapshot.  rows_loaded means the matrix already
+// holds the snapshot's dense rows.
+void Graph::load_snapshot(const Snapshot &snap, bool rows_loaded)
+{
+  int i;
+  uint64_t j;
+  int n = snap.size();
+  const unsigned long *rows;
+  const uint64_t *index = snap.csr_index();
+  const uint32_t *adj = snap.csr_adj();
+
+  if (n > max_nodes)
   {
-    g.connect(g.create_new_node(node1), g.create_new_node(node2));
+    cerr << "Error - cannot create new node in Graph - capacity exceeded." << endl;
+    exit(EXIT_FAILURE);
+  }
 
-    input >> node1 >> node2;
+  for (i=0; i<n; i++)
+  {
+    node_order.push_back(i);
+    used_nodes.set(i);
+    nodes[i] = snap.label(i);
+    if (nodes[i] != "") node2num[nodes[i]] = i;
+    degrees[i] = snap.degree(i);
   }
+  num_nodes = n;
+  free_hint = n;
+  num_edges = snap.esize();
 
-  input.close();
+  if (rows_loaded) return;
+  if (n == max_nodes && (rows = snap.dense_rows(row_uls)) != 0)
+  {
+    memcpy(matrix, rows, matrix_bytes);
+    return;
+  }
+  for (i=0; i<n; i++)
+    for (j=index[i]; j<index[i+1]; j++) edges[i].set(adj[j]);
 }
 
 // This function resets the graph to a clean, pristine state
@@ -134,6 +323,8 @@ void Graph::clear()
 
   for (i=0; i<max_nodes; i++) edges[i].reset();
   used_nodes.reset();
+  free_hint = 0;
+  degrees.assign(max_nodes, 0);
 
   node2num.clear();
 }
@@ -160,8 +351,8 @@ Graph::Vertices *Graph::new_vertices(int num)
 // Functions to insert a new node.  Only at most max_nodes nodes are allowed.
 // Note that this only brings the node into existence.  You must use connect
 // to then connect it to other nodes.
-// This routine currently uses an inefficient linear search to find the next
-// available slot.
+// The search for the next available slot starts at free_hint, so filling an
+// empty graph is linear overall.
 int Graph::create_new_node() {return create_new_node("");}
 int Graph::create_new_node(const string &name)
 {
@@ -175,7 +366,7 @@ int Graph::create_new_node(const string &name)
   }
 
   // Find available slot to store node
-  for (i=0; i<max_nodes; i++) {if (!used_nodes[i]) break;}
+  for (i=free_hint; i<max_nodes; i++) {if (!used_nodes[i]) break;}
   if (i >= max_nodes)
   {
     cerr << "Internal Graph Error - unable to find available node in Graph::create_new_node" << endl;
@@ -186,6 +377,7 @@ int Graph::create_new_node(const string &name)
   num_nodes++;
   node_order.push_back(i);
   used_nodes.set(i);
+  free_hint = i + 1;
   nodes[i] = name;
   if (name != "") node2num[name] = i;
 
@@ -194,39 +386,81 @@ int Graph::create_new_node(const string &name)
 
 void Graph::remove(int num)
 {
-  int i;
+  int i, b;
+  unsigned long w;
+  const unsigned long *r;
 
   if (num < 0 || num >= max_nodes || !used_nodes[num]) return;
 
   num_nodes--;
-  // Remove node's edges
-  for (i=0; i<max_nodes; i++)
+  r = row(num);
+  // Remove node's edges, visiting only its neighbors
+  for (i=0; i<row_uls; i++)
   {
-    if (edges[num][i])
+    for (w = r[i]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
     {
-      edges[i].reset(num);
-      num_edges--;
+      b = __builtin_clzl(w);
+      edges[i * NUM_ULBITS + b].reset(num);
+      degrees[i * NUM_ULBITS + b]--;
     }
   }
+  num_edges -= degrees[num];
+  degrees[num] = 0;
   (edges[num]).reset();
 
   // Do some more bookkeeping
   used_nodes.reset(num);
+  if (num < free_hint) free_hint = num;
   node2num.erase(nodes[num]);
 }
 
+// Remove a whole set at once.  Each remaining row loses the set's columns
+// in one and-not, rather than one bit per removed node.
 void Graph::remove(const Vertices &v)
 {
   int i;
+  long cross = 0, deg_sum = 0;
+  Vertices gone(v);
+
+  gone.v &= used_nodes;
+  if (gone.v.count() == 0) return;
+
+  for (i=0; i<max_nodes; i++)
+  {
+    if (!used_nodes[i]) continue;
+    if (gone.v[i])
+    {
+      deg_sum += degrees[i];
+      continue;
+    }
+    int lost = edges[i].and_count(gone.v);
+    if (lost == 0) continue;
+    edges[i].andnot(gone.v);
+    degrees[i] -= lost;
+    cross += lost;
+  }
 
-  for (i=0; i<max_nodes; i++) if (v.v[i]) remove(i);
+  // Edges inside the set are counted twice in deg_sum
+  num_edges -= cross + (deg_sum - cross) / 2;
+  for (i=0; i<max_nodes; i++)
+  {
+    if (!gone.v[i]) continue;
+    edges[i].reset();
+    degrees[i] = 0;
+    node2num.erase(nodes[i]);
+    num_nodes--;
+    if (i < free_hint) free_hint = i;
+  }
+  used_nodes.andnot(gone.v);
 }
 
 void Graph::remove_all_except(const Vertices &v)
 {
-  int i;
+  Vertices gone(*this);
 
-  for (i=0; i<max_nodes; i++) if (!v.v[i]) remove(i);
+  gone.fill();
+  gone.remove(v);
+  remove(gone);
 }
 
 // Functions to add/remove edges.  Note the lack of bounds checking and
@@ -243,6 +477,8 @@ void Graph::connect(int num1, int num2)
   {
     edges[num1].set(num2);
     edges[num2].set(num1);
+    degrees[num1]++;
+    degrees[num2]++;
     num_edges++;
   }
 }
@@ -253,10 +489,30 @@ void Graph::disconnect(int num1, int num2)
   {
     edges[num1].reset(num2);
     edges[num2].reset(num1);
+    degrees[num1]--;
+    degrees[num2]--;
     num_edges--;
   }
 }
 
+// Neighbors of n in increasing order, found by scanning the words of its row
+void Graph::nbr_array(int n, vector<int> &dest) const
+{
+  int i, b;
+  unsigned long w;
+  const unsigned long *r = row(n);
+
+  dest.clear();
+  for (i=0; i<bitarray::words_for(max_nodes); i++)
+  {
+    for (w = r[i]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+    {
+      b = __builtin_clzl(w);
+      dest.push_back(i * NUM_ULBITS + b);
+    }
+  }
+}
+
 int Graph::ldvertex() const
 {
   int i, n = -1;
@@ -326,6 +582,30 @@ int Graph::Vertices::hdvertex() const
   return n;
 }
 
+// A member n adjacent to d with no other neighbors outside N(d) is in a
+// clique only where d could take its place.  Members are removed as they
+// are found, which only makes later tests easier to pass.
+int Graph::Vertices::remove_dominated(int d)
+{
+  int i, b, n, num_removed = 0;
+  unsigned long w;
+  const unsigned long *r = g->row(d);
+
+  for (i=0; i<v.num_words(); i++)
+  {
+    for (w = r[i] & v.words()[i]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+    {
+      b = __builtin_clzl(w);
+      n = i * NUM_ULBITS + b;
+      if (!dominated(n, d)) continue;
+      remove(n);
+      ++num_removed;
+    }
+  }
+
+  return num_removed;
+}
+
 int Graph::Vertices::esize() const
 {
   int i,j;
@@ -352,6 +632,7 @@ void Graph::complement()
     if (!used_nodes[i]) continue;
     edges[i] ^= used_nodes;
     edges[i].reset(i);
+    degrees[i] = num_nodes - 1 - degrees[i];
   }
   num_edges = (num_nodes * (num_nodes - 1))/2 - num_edges;
 }
@@ -363,28 +644,32 @@ bool Graph::is_clique() const
 }
 
 // Sorting facility.  Reinitialize node_order to have all and only valid
-// nodes, and then call sort with appropriate function object.
-// NOTE:  Would like to make this more general, so that the user can
-// provide their own function or function object for sorting.  How can we
-// do this?
-void Graph::sort_by_degree_asc()
-{
-  int i;
-
-  node_order.resize(0);
-  for (i=0; i<max_nodes; i++) if (used_nodes[i]) node_order.push_back(i);
-
-  std::sort(node_order.begin(), node_order.end(), Graph_deg_sort_asc(*this));
-}
+// nodes, ordered by degree.  Degrees are known and bounded by num_nodes, so
+// a counting sort does it in linear time; nodes of equal degree stay in
+// number order.
+void Graph::sort_by_degree_asc() {sort_by_degree(0);}
+void Graph::sort_by_degree_des() {sort_by_degree(1);}
 
-void Graph::sort_by_degree_des()
+void Graph::sort_by_degree(bool descending)
 {
-  int i;
+  int i, d;
+  vector<int> start(num_nodes + 1, 0);
 
-  node_order.resize(0);
-  for (i=0; i<max_nodes; i++) if (used_nodes[i]) node_order.push_back(i);
+  for (i=0; i<max_nodes; i++)
+  {
+    if (!used_nodes[i]) continue;
+    d = descending ? num_nodes - 1 - degrees[i] : degrees[i];
+    start[d + 1]++;
+  }
+  for (d=0; d<num_nodes; d++) start[d + 1] += start[d];
 
-  std::sort(node_order.begin(), node_order.end(), Graph_deg_sort_des(*this));
+  node_order.resize(num_nodes);
+  for (i=0; i<max_nodes; i++)
+  {
+    if (!used_nodes[i]) continue;
+    d = descending ? num_nodes - 1 - degrees[i] : degrees[i];
+    node_order[start[d]++] = i;
+  }
 }
 
 void Graph::shrink(int maxn)
@@ -393,7 +678,11 @@ void Graph::shrink(int maxn)
   int old1, new1, old2, new2;
   int new_max_nodes;
   bitarray new_used_nodes;
-  bitarray *new_edges;
+  vector<int> new_degrees;
+  bitarray *old_edges = edges;
+  unsigned long *old_matrix = matrix;
+  size_t old_matrix_bytes = matrix_bytes;
+  bool old_matrix_mapped = matrix_mapped;
   vector<int> new_node_order;
   map<int, int> old2new;
   map<int, int>::iterator it, jt;
@@ -401,10 +690,11 @@ void Graph::shrink(int maxn)
   new_max_nodes = max(1, num_nodes);
   if (maxn > new_max_nodes) new_max_nodes = maxn;
 
-  // Allocate space to hold new graph data
-  new_edges = new bitarray[new_max_nodes];
-  for (i=0; i<new_max_nodes; ++i) new_edges[i].create(new_max_nodes);
+  // Allocate space to hold new graph data.  The old matrix stays alive
+  // (through old_edges) until the new one has been filled in.
+  alloc_matrix(new_max_nodes);
   new_used_nodes.create(new_max_nodes);
+  new_degrees.assign(new_max_nodes, 0);
 
   // Create mapping of old node numbers to new node numbers
   int next_id = 0;
@@ -424,6 +714,7 @@ void Graph::shrink(int maxn)
     new1 = it->second;
 
     new_used_nodes.set(new1);
+    new_degrees[new1] = degrees[old1];
     nodes[new1] = nodes[old1];  // Depends on numerical order
     if (nodes[new1] != "") node2num[nodes[new1]] = new1;
 
@@ -433,10 +724,10 @@ void Graph::shrink(int maxn)
     {
       old2 = jt->first;
       new2 = jt->second;
-      if (edges[old1][old2])
+      if (old_edges[old1][old2])
       {
-        new_edges[new1].set(new2);
-        new_edges[new2].set(new1);
+        edges[new1].set(new2);
+        edges[new2].set(new1);
       }
     }
   }
@@ -453,12 +744,70 @@ void Graph::shrink(int maxn)
   // Overwrite old graph data
   node_order = new_node_order;
   max_nodes = new_max_nodes;
-  delete [] edges;
-  edges = new_edges;
+  delete [] old_edges;
+  release_matrix(old_matrix, old_matrix_bytes, old_matrix_mapped);
   used_nodes = new_used_nodes;
+  degrees.swap(new_degrees);
+  free_hint = num_nodes;
   nodes.resize(new_max_nodes);
 }
 
+void Graph::reorder(const vector<int> &order)
+{
+  int i, k, b;
+  unsigned long w;
+  bitarray *old_edges = edges;
+  unsigned long *old_matrix = matrix;
+  size_t old_matrix_bytes = matrix_bytes;
+  bool old_matrix_mapped = matrix_mapped;
+  int num_words = bitarray::words_for(max_nodes);
+  vector<int> old2new(max_nodes, -1);
+  vector<string> new_nodes(max_nodes);
+  vector<int> new_degrees(max_nodes, 0);
+
+  for (i=0; i<(int)order.size(); ++i)
+  {
+    if (order[i] < 0 || order[i] >= max_nodes || !used_nodes[order[i]] ||
+        old2new[order[i]] != -1) break;
+    old2new[order[i]] = i;
+  }
+  if (i != num_nodes || (int)order.size() != num_nodes)
+  {
+    cerr << "Error - Graph::reorder() needs every node exactly once" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  alloc_matrix(max_nodes);
+  for (i=0; i<num_nodes; ++i)
+  {
+    const unsigned long *row = old_edges[order[i]].words();
+    for (k=0; k<num_words; ++k)
+    {
+      for (w = row[k]; w; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+      {
+        b = __builtin_clzl(w);
+        edges[i].set(old2new[k * NUM_ULBITS + b]);
+      }
+    }
+    new_nodes[i] = nodes[order[i]];
+    new_degrees[i] = degrees[order[i]];
+  }
+
+  nodes.swap(new_nodes);
+  degrees.swap(new_degrees);
+  node2num.clear();
+  for (i=0; i<num_nodes; ++i) if (nodes[i] != "") node2num[nodes[i]] = i;
+  for (i=k=0; i<(int)node_order.size(); ++i)
+    if (used_nodes[node_order[i]]) node_order[k++] = old2new[node_order[i]];
+  node_order.resize(k);
+  used_nodes.reset();
+  for (i=0; i<num_nodes; ++i) used_nodes.set(i);
+  free_hint = num_nodes;
+
+  delete [] old_edges;
+  release_matrix(old_matrix, old_matrix_bytes, old_matrix_mapped);
+}
+
 void Graph::Vertices::node_array(vector<int> &dest) const
 {
   dest.clear();
@@ -484,7 +833,7 @@ bool Graph::Vertices::is_clique() const
   {
     if (v[i])
     {
-      if ((v & g->edges[i]).count() < csize - 1) return 0;
+      if (!v.and_count_at_least(g->edges[i], csize - 1)) return 0;
     }
   }
 
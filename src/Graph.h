@@ -17,6 +17,9 @@
 using namespace std;
 using std::vector;
 
+struct Edge_List;
+class Snapshot;
+
 class Graph
 {
   // User View
@@ -29,6 +32,19 @@ class Graph
 
   bitarray *edges;  //  Bit matrix of edges (max_nodes x max_nodes)
   bitarray used_nodes;  // The num_nodes nodes currently being used
+  int free_hint;  // No unused node below this index
+  vector<int> degrees;  // Degree of each node, kept up to date by all edits
+
+  // Storage behind "edges".  The matrix is one row-major block aligned to a
+  // cache line (or a huge page when large), with every row padded to a whole
+  // number of cache lines.  Each edges[i] is a bitarray view of row i, so
+  // copying the matrix is a single memcpy and row access a pointer offset.
+  unsigned long *matrix;
+  int row_uls;  // Words per row, including padding
+  size_t matrix_bytes;
+  bool matrix_mapped;  // Matrix is a private mapping of a snapshot file
+
+  static bool huge_pages;
 
   vector<string> nodes;  // Node number to name mapping
   map<string, int> node2num;  // Node name to number mapping
@@ -44,13 +60,24 @@ class Graph
   Graph &operator=(const Graph &);
 
   private:
-  void init(int init_size, int max_size = 0);
+  void init(int init_size, int max_size = 0, unsigned long *rows = 0);
+  void alloc_matrix(int n, unsigned long *rows = 0);
+  void free_matrix();
+  void load_snapshot(const Snapshot &, bool rows_loaded);
   public:
   void clear();
   Vertices *new_vertices(int num = 1);
 
   // Destructor
-  ~Graph() {delete [] edges;} 
+  ~Graph() {free_matrix();}
+
+  // Large adjacency matrices are placed on transparent huge pages when the
+  // platform supports it.  On by default; affects matrices allocated after
+  // the call.
+  static void use_huge_pages(bool b) {huge_pages = b;}
+
+  // Words per matrix row for a graph of capacity n
+  static int row_words_for(int n);
 
   // Graph building methods
   int create_new_node();
@@ -61,12 +88,19 @@ class Graph
   void connect(int, int);
   void disconnect(int, int);
 
+  // Replace the graph's contents with a loaded edge list.  Node i gets
+  // el.labels[i]; rows of the matrix are filled in parallel.
+  void build(const Edge_List &el, int num_threads = 0);
+  void build(const Snapshot &);
+
   // Accessor methods
   int size() const {return num_nodes;}
   int nsize() const {return num_nodes;}
   int esize() const {return num_edges;}
   int max_size() const {return max_nodes;}
   bool connected(int n1, int n2) const {return edges[n1][n2];}
+  const unsigned long *row(int n) const {return matrix + (size_t)n * row_uls;}
+  int row_words() const {return row_uls;}
   string label(int n) const {return nodes[n];}
   int vertex(const string &n) const
   {
@@ -95,18 +129,22 @@ class Graph
   }
 
   // Degree counting functions
-  int degree(int n) const {return ((edges[n]).count());}
+  int degree(int n) const {return degrees[n];}
+  void nbr_array(int n, vector<int> &) const;
   int ldvertex() const;
   int hdvertex() const;
 
   // Common graph operations
   void complement();
-  int cmn_nbrs(int n1, int n2) const {return (edges[n1] & edges[n2]).count();}
+  int cmn_nbrs(int n1, int n2) const {return edges[n1].and_count(edges[n2]);}
   bool is_clique() const;
 
   // Sorting facilities - incorporated in version 2.0
   void sort_by_degree_asc();
   void sort_by_degree_des();
+  private:
+  void sort_by_degree(bool descending);
+  public:
 
   // Shrinking function, added July 27, 2006, to extend the usefulness of
   // a Graph.  After preprocessing or some other operation that removes
@@ -121,6 +159,12 @@ class Graph
   // preprocessing).
   void shrink(int maxn = 0);
 
+  // Renumber the nodes so that node order[i] becomes node i.  order must
+  // list every node exactly once.  Labels and node_order follow their
+  // nodes.  Useful when an algorithm scans nodes in number order (see
+  // Bitset_Color_Man).
+  void reorder(const vector<int> &order);
+
   // Nested pointer class for easy traversal in "node_order" order.
   class Vex_ptr
   {
@@ -202,11 +246,14 @@ class Graph
     void insert(int n) {v.set(n);}
     void remove(int n) {v.reset(n);}
 
+    // Copy of a set in the same graph, reusing this set's storage
+    void assign(const Vertices &v2) {v.assign(v2.v);}
+
     void insert(const Vertices &v2) {v |= v2.v;}
-    void remove(const Vertices &v2) {v ^= (v & v2.v);}
+    void remove(const Vertices &v2) {v.andnot(v2.v);}
 
     void insert_nbrs(int n) {v |= g->edges[n];}
-    void remove_nbrs(int n) {v ^= (v & g->edges[n]);}
+    void remove_nbrs(int n) {v.andnot(g->edges[n]);}
 
     void insert_nnbrs(int n) {v |= (~(g->edges[n]));}
     void remove_nnbrs(int n) {v &= g->edges[n];}
@@ -215,15 +262,29 @@ class Graph
     int size() const {return v.count();}
     int esize() const;
     Graph *graph() const {return g;}
+    // Raw words of the set, laid out like the rows of the graph (see
+    // Graph::row)
+    const unsigned long *words() const {return v.words();}
+    int num_words() const {return v.num_words();}
     void node_array(vector<int> &) const;
     void node_list(list<int> &) const;
-    int degree(int n) const {return (g->edges[n] & v).count();}
+    int degree(int n) const {return v.and_count(g->edges[n]);}
+    // Number of set members not adjacent to n (n itself counts if present)
+    int non_degree(int n) const {return v.andnot_count(g->edges[n]);}
+    bool degree_at_least(int n, int k) const
+                                 {return v.and_count_at_least(g->edges[n], k);}
+    bool has_nbr(int n) const {return v.intersects(g->edges[n]);}
+    // Members adjacent to n are all adjacent to d (d must not be a member)
+    bool dominated(int n, int d) const
+                          {return v.and_subset(g->edges[n], g->edges[d]);}
+    // Remove the members that d dominates and return their number
+    int remove_dominated(int d);
     int ldvertex(int min = 0) const;
     int hdvertex() const;
     int cmn_nbrs(int n1, int n2) const
-                         {return ((g->edges[n1] & g->edges[n2]) & v).count();}
+                           {return v.and_count(g->edges[n1], g->edges[n2]);}
     bool is_clique() const;
-    int overlap(const Vertices &v2) const {return (v & v2.v).count();}
+    int overlap(const Vertices &v2) const {return v.and_count(v2.v);}
 
     // July 30, 2007 - Equivalent to functions with same name in Graph, except
     // exclude vertices not in this particular vertex set.
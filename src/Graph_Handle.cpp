@@ -0,0 +1,264 @@
+#include <unordered_map>
+#include "Graph_Handle.h"
+
+// From the C maximal clique engine (graph_maximal.h cannot be included in
+// C++ code since its Graph type and macros clash with the C++ library)
+extern "C"
+{
+  struct graph_t *graph_from_csr(unsigned int n, const char **labels,
+                                 const uint64_t *index, const uint32_t *adj);
+  void graph_free(struct graph_t *);
+}
+
+Graph_Handle::Graph_Handle(const string &graph_file)
+:dense(0),
+ sparse(0),
+ maximal(0),
+ source(graph_file),
+ have_max_clique(0)
+{
+  int header_nodes;
+  long header_edges;
+  string file(graph_file);
+
+  read_graph_header(file, header_nodes, header_edges);
+  if (use_sparse_backend(header_nodes, header_edges))
+                                                 sparse = new Sparse_Graph(file);
+  else dense = new Graph(file);
+}
+
+Graph_Handle::Graph_Handle(Edge_List &el, const string &graph_source)
+:dense(0),
+ sparse(0),
+ maximal(0),
+ source(graph_source),
+ have_max_clique(0)
+{
+  int n = el.labels.size();
+
+  if (use_sparse_backend(n, el.edges.size()))
+  {
+    sparse = new Sparse_Graph;
+    sparse->build(el.labels, el.edges);
+  }
+  else
+  {
+    dense = new Graph(0, max(1, n));
+    dense->build(el);
+  }
+}
+
+Graph_Handle::Graph_Handle(Graph *g, const string &graph_source)
+:dense(g),
+ sparse(0),
+ maximal(0),
+ source(graph_source),
+ have_max_clique(0)
+{}
+
+Graph_Handle::~Graph_Handle()
+{
+  delete dense;
+  delete sparse;
+  if (maximal) graph_free(maximal);
+}
+
+struct graph_t *Graph_Handle::maximal_graph()
+{
+  int i, n;
+  vector<int> nbrs;
+  vector<string> labels;
+  vector<const char *> label_ptrs;
+  vector<uint64_t> index(1, 0);
+  vector<uint32_t> adj;
+
+  if (maximal) return maximal;
+
+  n = dense ? dense->size() : sparse->size();
+  for (i=0; i<n; ++i)
+  {
+    if (dense)
+    {
+      labels.push_back(dense->label(i));
+      dense->nbr_array(i, nbrs);
+    }
+    else
+    {
+      labels.push_back(sparse->label(i));
+      nbrs.assign(sparse->nbrs_begin(i), sparse->nbrs_end(i));
+    }
+    adj.insert(adj.end(), nbrs.begin(), nbrs.end());
+    index.push_back(adj.size());
+  }
+  for (i=0; i<n; ++i) label_ptrs.push_back(labels[i].c_str());
+
+  maximal = graph_from_csr(n, n ? &label_ptrs[0] : 0, &index[0],
+                                                     adj.empty() ? 0 : &adj[0]);
+  return maximal;
+}
+
+Graph_Handle *graph_handle(SEXP handle)
+{
+  Rcpp::XPtr<Graph_Handle> p(handle);
+  if (p.get() == 0)
+    Rcpp::stop("cliqueR graph handle is no longer valid; reload the graph with cliqueR.load");
+  return p.get();
+}
+
+// Entry point for the C maximal clique driver.  Returns 0 for an invalid
+// handle, since R errors must not unwind through C code.
+extern "C" struct graph_t *graph_handle_maximal(SEXP handle)
+{
+  Graph_Handle *h;
+
+  if (TYPEOF(handle) != EXTPTRSXP) return 0;
+  h = (Graph_Handle *)R_ExternalPtrAddr(handle);
+  return h ? h->maximal_graph() : 0;
+}
+
+// [[Rcpp::export]]
+SEXP load_graph_handle(std::string filename)
+{
+  Rcpp::XPtr<Graph_Handle> handle(new Graph_Handle(filename), true);
+  return handle;
+}
+
+// Node number of a label, numbering new labels as they appear
+template <class Key>
+static int label_id(unordered_map<Key, int> &ids, Key key, Edge_List &el,
+                                                     const string &label)
+{
+  typename unordered_map<Key, int>::iterator it = ids.find(key);
+  if (it != ids.end()) return it->second;
+  ids[key] = el.labels.size();
+  el.labels.push_back(label);
+  return el.labels.size() - 1;
+}
+
+// Whole-number label of an R integer or double, or stop on a missing or
+// fractional value
+static long long numeric_label(SEXP column, R_xlen_t k)
+{
+  if (TYPEOF(column) == INTSXP)
+  {
+    int v = INTEGER(column)[k];
+    if (v == NA_INTEGER) Rcpp::stop("edge list contains missing values");
+    return v;
+  }
+
+  double v = REAL(column)[k];
+  if (ISNAN(v)) Rcpp::stop("edge list contains missing values");
+  if (v != (double)(long long)v)
+    Rcpp::stop("numeric vertex labels must be whole numbers");
+  return (long long)v;
+}
+
+// Fill el from m rows of two label columns (integer, double or character
+// vectors), read in place starting at from[from_off] and to[to_off].  Labels
+// are numbered in the same order as load_edge_list, so a graph built in R
+// matches the same edges read from a file.
+static void edge_list_from_columns(SEXP from, R_xlen_t from_off, SEXP to,
+                              R_xlen_t to_off, R_xlen_t m, Edge_List &el)
+{
+  R_xlen_t k;
+
+  if (TYPEOF(from) != TYPEOF(to))
+    Rcpp::stop("edge list columns must have the same type");
+  el.edges.resize(m);
+
+  if (TYPEOF(from) == STRSXP)
+  {
+    // R keeps a single copy of each distinct string, so labels can be
+    // hashed by address instead of by content
+    unordered_map<SEXP, int> ids;
+    for (k=0; k<m; ++k)
+    {
+      SEXP a = STRING_ELT(from, from_off + k), b = STRING_ELT(to, to_off + k);
+      if (a == NA_STRING || b == NA_STRING)
+        Rcpp::stop("edge list contains missing values");
+      el.edges[k].second = label_id(ids, b, el, string(CHAR(b)));
+      el.edges[k].first = label_id(ids, a, el, string(CHAR(a)));
+    }
+  }
+  else if (TYPEOF(from) == INTSXP || TYPEOF(from) == REALSXP)
+  {
+    unordered_map<long long, int> ids;
+    for (k=0; k<m; ++k)
+    {
+      long long a = numeric_label(from, from_off + k);
+      long long b = numeric_label(to, to_off + k);
+      el.edges[k].second = label_id(ids, b, el, to_string(b));
+      el.edges[k].first = label_id(ids, a, el, to_string(a));
+    }
+  }
+  else Rcpp::stop("vertex labels must be integer, numeric or character");
+}
+
+// Build a dense Graph from the upper triangle of an n x n logical, integer
+// or numeric matrix; nonzero, non-missing entries are edges.
+static Graph *graph_from_adjacency(SEXP adj, const vector<string> &labels)
+{
+  int i, j;
+  int n = Rf_nrows(adj);
+  bool edge;
+
+  if (Rf_ncols(adj) != n || (int)labels.size() != n)
+    Rcpp::stop("adjacency matrix must be square with one label per vertex");
+  if (TYPEOF(adj) != LGLSXP && TYPEOF(adj) != INTSXP && TYPEOF(adj) != REALSXP)
+    Rcpp::stop("adjacency matrix must be logical, integer or numeric");
+
+  Graph *g = new Graph(0, max(1, n));
+  for (i=0; i<n; ++i)
+  {
+    if (g->create_new_node(labels[i]) != i)
+    {
+      delete g;
+      Rcpp::stop("adjacency matrix has duplicate vertex labels");
+    }
+  }
+
+  // Column-major, so each column's upper part is contiguous
+  for (j=1; j<n; ++j)
+  {
+    for (i=0; i<j; ++i)
+    {
+      size_t k = (size_t)j * n + i;
+      if (TYPEOF(adj) == REALSXP) edge = REAL(adj)[k] != 0 && !ISNAN(REAL(adj)[k]);
+      else if (TYPEOF(adj) == INTSXP)
+                     edge = INTEGER(adj)[k] != 0 && INTEGER(adj)[k] != NA_INTEGER;
+      else edge = LOGICAL(adj)[k] != 0 && LOGICAL(adj)[k] != NA_LOGICAL;
+      if (edge) g->connect(i, j);
+    }
+  }
+  return g;
+}
+
+// Graph from an edge list given either as two vectors, or (with to = NULL)
+// as the first two columns of a matrix
+// [[Rcpp::export]]
+SEXP edges_graph_handle(SEXP from, SEXP to)
+{
+  Edge_List el;
+
+  if (Rf_isNull(to))
+  {
+    if (Rf_ncols(from) < 2) Rcpp::stop("edge list matrix needs two columns");
+    edge_list_from_columns(from, 0, from, Rf_nrows(from), Rf_nrows(from), el);
+  }
+  else
+  {
+    if (Rf_xlength(from) != Rf_xlength(to))
+      Rcpp::stop("edge list columns must have the same length");
+    edge_list_from_columns(from, 0, to, 0, Rf_xlength(from), el);
+  }
+  Rcpp::XPtr<Graph_Handle> handle(new Graph_Handle(el, ""), true);
+  return handle;
+}
+
+// [[Rcpp::export]]
+SEXP adjacency_graph_handle(SEXP adj, std::vector<std::string> labels)
+{
+  Graph *g = graph_from_adjacency(adj, labels);
+  Rcpp::XPtr<Graph_Handle> handle(new Graph_Handle(g, ""), true);
+  return handle;
+}
@@ -0,0 +1,60 @@
+// Persistent graph handles
+// A Graph_Handle keeps a loaded graph alive across R calls (see
+// cliqueR.load and cliqueR.graph), so a session that runs several queries
+// on one network parses it once.  The handle owns the dense Graph or, for
+// very large sparse graphs, the Sparse_Graph, builds the C maximal clique
+// engine's graph from it on first use, and caches query results.  The
+// loaded graph itself is never modified; queries that need to alter it work
+// on a copy.
+
+#ifndef _GRAPH_HANDLE_H
+#define _GRAPH_HANDLE_H 1
+
+#include <Rcpp.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "Graph.h"
+#include "Sparse_Graph.h"
+#include "Edge_Loader.h"
+using namespace std;
+
+struct graph_t;  // Graph of the C maximal clique engine (graph_maximal.h)
+
+class Graph_Handle
+{
+  Graph *dense;
+  Sparse_Graph *sparse;
+  struct graph_t *maximal;
+
+  public:
+  string source;  // File the graph was loaded from ("" if built in R)
+
+  // Cached results.  paracliques is keyed by the (normalized) arguments of
+  // find_paracliques.
+  bool have_max_clique;
+  vector<string> max_clique;
+  map<vector<double>, vector<vector<string> > > paracliques;
+
+  // Constructors and destructor.  The last two take ownership of their
+  // graph (el is consumed).
+  Graph_Handle(const string &graph_file);
+  Graph_Handle(Edge_List &el, const string &source);
+  Graph_Handle(Graph *g, const string &source);
+  ~Graph_Handle();
+
+  // Accessor methods.  Exactly one of graph() and sparse_graph() is non-null.
+  const Graph *graph() const {return dense;}
+  const Sparse_Graph *sparse_graph() const {return sparse;}
+  struct graph_t *maximal_graph();
+
+  private:
+  Graph_Handle(const Graph_Handle &);
+  Graph_Handle &operator=(const Graph_Handle &);
+};
+
+// The handle behind an R external pointer.  Stops with an R error if the
+// pointer is not a live handle (for example after a session is restored).
+Graph_Handle *graph_handle(SEXP handle);
+
+#endif
@@ -1,4 +1,8 @@
 #include "MC_Heuristic.h"
+#include "Core_Decomposition.h"
+
+// Number of seeds tried by Degeneracy_Clique
+#define DEGENERACY_SEEDS 64
 
 int Greedy_Clique::operator() (Graph::Vertices &subgraph,
                                                Graph::Vertices &clique) const
@@ -16,3 +20,44 @@ int Greedy_Clique::operator() (Graph::Vertices &subgraph,
 
   return clique.size();
 }
+
+int Degeneracy_Clique::operator() (Graph::Vertices &subgraph,
+                                               Graph::Vertices &clique) const
+{
+  int i, j, n, hdnode, num_seeds = 0;
+  vector<int> order, core;
+  Graph *base_graph = subgraph.graph();
+  Graph::Vertices pool(subgraph);
+  Graph::Vertices candidates(*base_graph);
+  Graph::Vertices current(*base_graph);
+
+  core_order(subgraph, order, core);
+  for (i=order.size()-1; i>=0 && num_seeds<DEGENERACY_SEEDS; --i)
+  {
+    // Core numbers only fall from here on
+    n = order[i];
+    if (core[n] + 1 <= clique.size()) break;
+    ++num_seeds;
+
+    current.clear();
+    current.insert(n);
+    candidates.assign(pool);
+    candidates.remove_nnbrs(n);
+    while (candidates.size() > 0)
+    {
+      hdnode = candidates.hdvertex();
+      candidates.remove_nnbrs(hdnode);
+      candidates.remove(hdnode);
+      current.insert(hdnode);
+    }
+    if (current.size() <= clique.size()) continue;
+    clique.clear();
+    clique.insert(current);
+
+    // Nodes of too low a core number cannot be in a larger clique
+    for (j=0; j<i && core[order[j]] + 1 <= clique.size(); ++j)
+                                                       pool.remove(order[j]);
+  }
+
+  return clique.size();
+}
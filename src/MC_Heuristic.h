@@ -56,4 +56,17 @@ class Greedy_Clique : public MC_Heuristic
   int operator() (Graph::Vertices &, Graph::Vertices &) const;
 };
 
+// Greedy search seeded from the densest part of the graph.  Seeds are taken
+// in reverse degeneracy order (see Core_Decomposition.h), and each is
+// extended greedily, by highest degree, among its neighbors whose core
+// number still allows a larger clique.  Seeding stops once the core numbers
+// show that no seed can beat the best clique, or after a fixed number of
+// seeds.
+class Degeneracy_Clique : public MC_Heuristic
+{
+  public:
+  using MC_Heuristic::operator();
+  int operator() (Graph::Vertices &, Graph::Vertices &) const;
+};
+
 #endif
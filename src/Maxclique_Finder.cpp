@@ -6,20 +6,279 @@
 // WARNING:  Input graph is altered!
 
 #include <iostream>
+#include <algorithm>
 #include <sys/time.h>
 #include "Graph.h"
 #include "Candidate_Manager.h"
 #include "Clique_Test.h"
 #include "Preprocessor.h"
 #include "Degree_Preprocessor.h"
+#include "Core_Decomposition.h"
+#include "Truss_Preprocessor.h"
+#include "Twin_Reduction.h"
+#include "Components.h"
 #include "MC_Heuristic.h"
 #include "Brancher.h"
+#include "Par_Brancher.h"
+#include "Static_Brancher.h"
+#include "Fixed_Brancher.h"
+#include "Sparse_Graph.h"
+#include "Maxclique_Finder.h"
 
 using namespace std;
 
-Graph::Vertices *find_mc(Graph *g)
+// Sparse graphs whose core has more vertices than this are searched one
+// vertex neighborhood at a time (see find_mc_by_vertex)
+#define VERTEX_SEARCH_MIN_NODES 1024
+
+// Graphs smaller than this (after preprocessing) are searched serially,
+// since starting threads would cost more than the search
+#define PAR_MIN_NODES 128
+
+static int search_threads = 1;
+
+int set_mc_threads(int num_threads)
+{
+  int old = search_threads;
+  search_threads = max(1, num_threads);
+  return old;
+}
+
+int mc_threads() {return search_threads;}
+
+static bool search_dominance = 0;
+
+bool set_mc_dominance(bool dominance)
+{
+  bool old = search_dominance;
+  search_dominance = dominance;
+  return old;
+}
+
+bool mc_dominance() {return search_dominance;}
+
+// Branch from maximum_clique with the standard strategy, stopping at a
+// clique of max_size nodes if it is positive
+static void branch_mc(Brancher &branch, Graph *g,
+                      Graph::Vertices *maximum_clique, int max_size)
+{
+  Sat_Color_Man scm;
+  branch.set_cand_man(&scm);
+  branch.set_best_to_worst_search();
+  if (search_dominance) branch.dominance_on();
+  branch.set_max_size(max_size);
+  branch(*g, *maximum_clique);
+}
+
+template <int N, class Bound>
+static void branch_fixed_n(Graph *g, Graph::Vertices *maximum_clique,
+                                                        const Bound &b)
+{
+  Fixed_Brancher<N, Bound> branch(b);
+  branch.set_dominance(search_dominance);
+  branch(*g, *maximum_clique);
+}
+
+// Branch from maximum_clique with the smallest Fixed_Brancher that holds g,
+// if there is one
+template <class Bound>
+static bool branch_fixed(Graph *g, Graph::Vertices *maximum_clique,
+                                                      const Bound &b)
+{
+  int n = g->max_size();
+
+  if (n <= 64) branch_fixed_n<64>(g, maximum_clique, b);
+  else if (n <= 128) branch_fixed_n<128>(g, maximum_clique, b);
+  else if (n <= 256) branch_fixed_n<256>(g, maximum_clique, b);
+  else if (n <= 512) branch_fixed_n<512>(g, maximum_clique, b);
+  else if (n <= 1024) branch_fixed_n<1024>(g, maximum_clique, b);
+  else if (n <= 2048) branch_fixed_n<2048>(g, maximum_clique, b);
+  else if (n <= 4096) branch_fixed_n<4096>(g, maximum_clique, b);
+  else return 0;
+
+  return 1;
+}
+
+// Number the nodes of g in reverse degeneracy order (the last node peeled
+// first), the order in which Bitset_Color_Man should color them.  Dense
+// cores come first, and each node has few neighbors numbered before it,
+// which keeps early color classes large.
+static void number_by_core(Graph *g)
+{
+  vector<int> order, core;
+  Graph::Vertices v(*g);
+
+  v.fill();
+  core_order(v, order, core);
+  reverse(order.begin(), order.end());
+  g->reorder(order);
+}
+
+// Shared state of a search over the components of a graph
+struct Component_Search
+{
+  Graph *g;
+  vector<vector<int> > comps;  // Components, highest bound first
+  vector<int> bounds;          // Color bound of each component
+  atomic<int> next_comp;
+  atomic<int> best_size;
+  mutex best_lock;             // Guards *best
+  Graph::Vertices *best;
+  int limit;                   // Known upper bound on best_size (0 if none)
+};
+
+struct Bound_Order
+{
+  const vector<int> &bound;
+  Bound_Order(const vector<int> &b) :bound(b) {}
+  bool operator() (int a, int b) const {return bound[a] > bound[b];}
+};
+
+// Components of g, highest color bound first, with their bounds
+static void split_components(Graph *g, vector<vector<int> > &comps,
+                                                    vector<int> &bounds)
+{
+  int i, j;
+  Bitset_Coloring coloring;
+  Graph::Vertices v(*g);
+  vector<vector<int> > found;
+  vector<int> found_bounds, order, nodes, colors;
+
+  v.fill();
+  connected_components(v, found);
+  for (i=0; i<(int)found.size(); ++i)
+  {
+    v.clear();
+    for (j=0; j<(int)found[i].size(); ++j) v.insert(found[i][j]);
+    found_bounds.push_back(coloring.color(v, nodes, colors));
+    order.push_back(i);
+  }
+  stable_sort(order.begin(), order.end(), Bound_Order(found_bounds));
+
+  comps.resize(order.size());
+  bounds.resize(order.size());
+  for (i=0; i<(int)order.size(); ++i)
+  {
+    comps[i].swap(found[order[i]]);
+    bounds[i] = found_bounds[order[i]];
+  }
+}
+
+// Remove the components of g that hold no clique of min_clique_size nodes.
+// Returns the number of components left.
+static int prune_components(Graph *g, int min_clique_size)
+{
+  int i, j, num_left;
+  vector<vector<int> > comps;
+  vector<int> bounds;
+  Graph::Vertices dead(*g);
+
+  split_components(g, comps, bounds);
+  for (num_left=0; num_left<(int)comps.size(); ++num_left)
+                                  if (bounds[num_left] < min_clique_size) break;
+  if (num_left == (int)comps.size()) return num_left;
+
+  dead.clear();
+  for (i=num_left; i<(int)comps.size(); ++i)
+            for (j=0; j<(int)comps[i].size(); ++j) dead.insert(comps[i][j]);
+  g->remove(dead);
+  return num_left;
+}
+
+// Search components until none are left that can beat the best clique.
+// Each is copied to a graph of its own and searched with a bound shared
+// with the other threads.
+static void component_search(Component_Search *s)
+{
+  int c;
+
+  while ((c = s->next_comp++) < (int)s->comps.size())
+  {
+    // Components are sorted by bound, so no later one can do better
+    if (s->bounds[c] <= s->best_size.load()) break;
+    if (s->limit > 0 && s->best_size.load() >= s->limit) break;
+
+    Graph *sub = component_graph(*s->g, s->comps[c]);
+    Graph::Vertices clique(*sub);
+    clique.clear();
+    if (!branch_fixed(sub, &clique,
+                      Shared_Bound(&s->best_size, 0, s->limit)))
+    {
+      Static_Brancher<Sat_Color_Man, 1, Shared_Bound>
+                          branch(Shared_Bound(&s->best_size, 0, s->limit));
+      branch.set_dominance(search_dominance);
+      branch(*sub, clique);
+    }
+
+    if (clique.size() > s->best_size.load())
+    {
+      lock_guard<mutex> guard(s->best_lock);
+      if (clique.size() > s->best_size.load())
+      {
+        s->best->clear();
+        Graph::Vertices::Vex_ptr vp(clique);
+        for (; !vp.end(); ++vp) s->best->insert(s->comps[c][*vp]);
+        s->best_size = s->best->size();
+      }
+    }
+
+    delete sub;
+  }
+}
+
+// Branch over the components of g, starting from maximum_clique, until a
+// clique of max_size nodes is found if it is positive
+static void branch_components(Graph *g, Graph::Vertices *maximum_clique,
+                                                          int max_size)
+{
+  int i;
+  Component_Search s;
+  vector<thread> workers;
+
+  s.g = g;
+  s.best = maximum_clique;
+  s.next_comp = 0;
+  s.limit = max_size;
+  split_components(g, s.comps, s.bounds);
+
+  // With several threads, a large first component that holds
+  // maximum_clique is searched by all of them with a Par_Brancher, and the
+  // other components are then spread over the threads
+  if (search_threads > 1 && (int)s.comps[0].size() >= PAR_MIN_NODES)
+  {
+    Graph *sub = component_graph(*g, s.comps[0]);
+    Graph::Vertices clique(*sub);
+    clique.clear();
+    for (i=0; i<(int)s.comps[0].size(); ++i)
+              if (maximum_clique->in_set(s.comps[0][i])) clique.insert(i);
+    if (clique.size() == maximum_clique->size())
+    {
+      Par_Brancher branch(search_threads);
+      branch_mc(branch, sub, &clique, max_size);
+      maximum_clique->clear();
+      Graph::Vertices::Vex_ptr vp(clique);
+      for (; !vp.end(); ++vp) maximum_clique->insert(s.comps[0][*vp]);
+      s.next_comp = 1;
+    }
+    delete sub;
+  }
+  s.best_size = maximum_clique->size();
+
+  for (i=1; i<search_threads; ++i)
+                           workers.push_back(thread(component_search, &s));
+  component_search(&s);
+  for (i=0; i<(int)workers.size(); ++i) workers[i].join();
+}
+
+// The search behind find_mc.  If bound is not null, only cliques larger
+// than *bound - offset are wanted, and *bound may be raised by other threads
+// during the search; a smaller clique may then be returned.  max_size is
+// as in find_mc.
+static Graph::Vertices *search_mc(Graph *g, const atomic<int> *bound,
+                                            int offset, int max_size = 0)
 {
   int mc_size;
+  int num_comps = 1;
   
   
   // Variables for timing
@@ -36,43 +295,239 @@ Graph::Vertices *find_mc(Graph *g)
   // Run heuristic to find lower bound
   //BENCHMARK << "Applying heuristic" << endl;
   Greedy_Clique gc;
-  mc_size = gc(*g);
+  Degeneracy_Clique dc;
+  Graph::Vertices heuristic_clique(*g);
+  Graph::Vertices degeneracy_clique(*g);
+  gc(*g, heuristic_clique);
+  if (dc(*g, degeneracy_clique) > heuristic_clique.size())
+                                    heuristic_clique.assign(degeneracy_clique);
+  mc_size = heuristic_clique.size();
   //BENCHMARK << "Heuristic clique size:  " << mc_size << endl;
+
+  // A clique as large as a known upper bound needs no search
+  if (max_size > 0 && mc_size >= max_size)
+                                  return new Graph::Vertices(heuristic_clique);
+  if (bound) mc_size = max(mc_size, bound->load() - offset + 1);
+
+  // Strip nodes outside the (mc_size-1)-core in linear time, before the
+  // recursive preprocessing
+  Graph::Vertices survivors(*g);
+  survivors.fill();
+  if (Core_Preprocessor(survivors, mc_size) > 0)
+                                            g->remove_all_except(survivors);
+
+  // Disconnect edges in too few triangles for a clique of mc_size nodes.
+  // A search with a shared bound already runs on a worker thread.
+  Truss_Preprocessor(*g, mc_size, bound ? 1 : search_threads);
+
+  // Keep one node of each class of false twins
+  Twin_Preprocessor(*g);
   
   // Setup preprocessing strategy
   //BENCHMARK << "Setting up preprocessing" << endl;
   Preprocessor preproc;
-  Color_Test ct;
+  MaxSAT_Test mt;
   Lazy_Low_Degree_Man ldm;
-  preproc.add_test(&ct, &ldm, 1);
+  preproc.add_test(&mt, &ldm, 1);
   //BENCHMARK << "Ready to preprocess" << endl;
   
   // Preprocess graph
   //BENCHMARK "Preprocessing" << endl;
   preproc(*g, mc_size);
+
+  // Drop components that cannot hold a clique of mc_size nodes.  A search
+  // with a shared bound is a neighborhood and stays in one piece.
+  if (!bound) num_comps = prune_components(g, mc_size);
   //BENCHMARK << "Preprocessed to:  " << g->size() << " " << g->esize() << endl;
   
   // Shrink graph
   //BENCHMARK << "Shrinking graph" << endl;
   g->shrink();
+  number_by_core(g);
   //BENCHMARK << "Shrinking complete" << endl;
   
   // Rerun heuristic
   Graph::Vertices *maximum_clique = new Graph::Vertices(*g);
+  Graph::Vertices reduced_clique(*g);
   maximum_clique->clear();
   //BENCHMARK << "Applying heuristic again" << endl;
   gc(*g, *maximum_clique);
+  if (dc(*g, reduced_clique) > maximum_clique->size())
+                                       maximum_clique->assign(reduced_clique);
   //BENCHMARK << "Heuristic clique size:  " << maximum_clique->size() << endl;
+  if (max_size > 0 && maximum_clique->size() >= max_size)
+                                                      return maximum_clique;
   
   // Run branching
   //BENCHMARK << "Branching" << endl;
-  Brancher branch;
-  
-  Prep_Low_Degree_Man pldm;
-  branch.set_cand_man(&pldm);
-  branch.set_best_to_worst_search();
-  branch(*g, *maximum_clique);
+  if (bound)
+  {
+    if (!branch_fixed(g, maximum_clique,
+                      Shared_Bound(bound, offset, max_size)))
+    {
+      Static_Brancher<Sat_Color_Man, 1, Shared_Bound>
+                              branch(Shared_Bound(bound, offset, max_size));
+      branch.set_dominance(search_dominance);
+      branch(*g, *maximum_clique);
+    }
+  }
+  else if (num_comps > 1) branch_components(g, maximum_clique, max_size);
+  else if (search_threads > 1 && g->size() >= PAR_MIN_NODES)
+  {
+    Par_Brancher branch(search_threads);
+    branch_mc(branch, g, maximum_clique, max_size);
+  }
+  else if (!branch_fixed(g, maximum_clique, Own_Bound(max_size)))
+  {
+    Brancher branch;
+    branch_mc(branch, g, maximum_clique, max_size);
+  }
   
   //BENCHMARK << "Finish" << endl;
   return maximum_clique;
 }
+
+Graph::Vertices *find_mc(Graph *g, int max_size)
+{
+  return search_mc(g, 0, 0, max_size);
+}
+
+// Shared state of a vertex-centric search
+struct Vertex_Search
+{
+  const Sparse_Graph *sg;
+  const vector<char> *alive;
+  vector<int> order;     // Degeneracy order
+  vector<int> core;      // Core numbers
+  vector<int> pos;       // Position of each vertex in order
+  vector<int> roots;     // Subproblem vertices, highest core first
+  atomic<int> next_root;
+  atomic<int> best_size;
+  mutex best_lock;       // Guards *best
+  vector<int> *best;
+};
+
+struct Core_Order
+{
+  const vector<int> &core;
+  Core_Order(const vector<int> &c) :core(c) {}
+  bool operator() (int a, int b) const {return core[a] > core[b];}
+};
+
+// Solve subproblems until none are left.  The subproblem of v is the
+// subgraph induced by v's neighbors later in the degeneracy order; every
+// clique is found in the subproblem of its earliest vertex.
+static void vertex_search(Vertex_Search *s)
+{
+  const Sparse_Graph &sg = *s->sg;
+  const vector<char> &alive = *s->alive;
+  vector<int> sparse2dense(sg.size(), -1);
+  vector<int> later;
+  const int *p;
+  int r, v;
+
+  while ((r = s->next_root++) < (int)s->roots.size())
+  {
+    v = s->roots[r];
+
+    // Roots are sorted by core number, so no later root can do better
+    if (s->core[v] + 1 <= s->best_size.load()) break;
+
+    later.clear();
+    for (p = sg.nbrs_begin(v); p != sg.nbrs_end(v); ++p)
+      if (alive[*p] && s->pos[*p] > s->pos[v]) later.push_back(*p);
+    if ((int)later.size() + 1 <= s->best_size.load()) continue;
+
+    // Search for a clique of at least best_size in the neighborhood
+    Graph *g = build_dense_subgraph(sg, later, sparse2dense);
+    g->sort_by_degree_asc();
+    Graph::Vertices *mc = search_mc(g, &s->best_size, 1);
+
+    if (mc->size() + 1 > s->best_size.load())
+    {
+      lock_guard<mutex> guard(s->best_lock);
+      if (mc->size() + 1 > s->best_size.load())
+      {
+        s->best->assign(1, v);
+        Graph::Vertices::Vex_ptr vp(*mc);
+        for (; !vp.end(); ++vp) s->best->push_back(sg.vertex(g->label(*vp)));
+        s->best_size = s->best->size();
+      }
+    }
+
+    delete mc;
+    delete g;
+  }
+}
+
+int find_mc_by_vertex(const Sparse_Graph &sg, const vector<char> &alive,
+                                         vector<int> &clique, int num_threads)
+{
+  int i, n;
+  Vertex_Search s;
+  vector<thread> workers;
+
+  s.sg = &sg;
+  s.alive = &alive;
+  s.best = &clique;
+  s.best_size = clique.size();
+  s.next_root = 0;
+
+  sparse_core_order(sg, alive, s.order, s.core);
+  s.pos.assign(sg.size(), 0);
+  for (i=0; i<(int)s.order.size(); ++i) s.pos[s.order[i]] = i;
+
+  // High cores first, since they are the most likely to raise the bound
+  for (i=0; i<(int)s.order.size(); ++i)
+  {
+    n = s.order[i];
+    if (s.core[n] + 1 > s.best_size) s.roots.push_back(n);
+  }
+  stable_sort(s.roots.begin(), s.roots.end(), Core_Order(s.core));
+
+  if (num_threads <= 0) num_threads = search_threads;
+  for (i=1; i<num_threads; ++i) workers.push_back(thread(vertex_search, &s));
+  vertex_search(&s);
+  for (i=0; i<(int)workers.size(); ++i) workers[i].join();
+
+  return clique.size();
+}
+
+int find_mc(const Sparse_Graph &sg, const vector<char> &alive,
+                                     vector<int> &clique)
+{
+  int n;
+  int mc_size;
+  vector<char> core(alive);
+  vector<int> keep;
+
+  // Heuristic lower bound on the whole sparse graph
+  mc_size = sparse_greedy_clique(sg, alive, clique);
+
+  // Any larger clique lies in the mc_size-core
+  sparse_core_prune(sg, core, mc_size);
+  for (n=0; n<sg.size(); ++n) if (core[n]) keep.push_back(n);
+  if ((int)keep.size() <= mc_size) return mc_size;
+
+  // A large core is searched neighborhood by neighborhood rather than as
+  // one dense graph
+  if ((int)keep.size() > VERTEX_SEARCH_MIN_NODES)
+                                    return find_mc_by_vertex(sg, core, clique);
+
+  // Exact search on the dense subgraph of the survivors
+  Graph *g = build_dense_subgraph(sg, keep);
+  g->sort_by_degree_asc();
+  Graph::Vertices *maximum_clique = find_mc(g);
+
+  if (maximum_clique->size() > mc_size)
+  {
+    clique.clear();
+    Graph::Vertices::Vex_ptr vp(*maximum_clique);
+    for (; !vp.end(); ++vp) clique.push_back(sg.vertex(g->label(*vp)));
+    mc_size = clique.size();
+  }
+
+  delete maximum_clique;
+  delete g;
+  return mc_size;
+}
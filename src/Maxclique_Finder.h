@@ -9,6 +9,41 @@
 #ifndef _MAXCLIQUE_FINDER_H
 #define _MAXCLIQUE_FINDER_H 1
 
+#include <vector>
 #include "Graph.h"
-Graph::Vertices *find_mc(Graph *g);
+#include "Sparse_Graph.h"
+// max_size, if positive, is known to bound the clique size from above (for
+// example, the size of a maximum clique of a graph g was taken from), and
+// the search ends as soon as a clique of that size is found, whether by the
+// heuristics or while branching.
+Graph::Vertices *find_mc(Graph *g, int max_size = 0);
+
+// Number of threads find_mc branches with (default 1).  With more than one,
+// a Par_Brancher is used on all but small graphs.  set_mc_threads returns
+// the previous setting.
+int set_mc_threads(int num_threads);
+int mc_threads();
+
+// Whether find_mc removes the candidates a node dominates once its branch is
+// searched (default off; see Brancher::dominance_on).  Preprocessing always
+// removes dominated nodes.  set_mc_dominance returns the previous setting.
+bool set_mc_dominance(bool dominance);
+bool mc_dominance();
+
+// Sparse front end for very large graphs.  Runs the heuristic and core
+// pruning on the alive part of the CSR graph, then the dense find_mc on the
+// subgraph induced by the survivors.  The clique is returned as Sparse_Graph
+// vertex numbers, and its size is returned.
+int find_mc(const Sparse_Graph &sg, const std::vector<char> &alive,
+                                     std::vector<int> &clique);
+
+// Vertex-centric search, used by the sparse find_mc for large cores.  Orders
+// the alive vertices by degeneracy and searches each vertex's later
+// neighborhood as a small dense Graph, skipping vertices whose core number
+// cannot beat the best clique so far.  Subproblems are shared among
+// num_threads threads (0 means the find_mc setting) with a common bound.
+// clique holds a known clique on entry (possibly empty) and the maximum
+// clique on return; its size is returned.
+int find_mc_by_vertex(const Sparse_Graph &sg, const std::vector<char> &alive,
+                      std::vector<int> &clique, int num_threads = 0);
 #endif
@@ -0,0 +1,190 @@
+#include "Par_Brancher.h"
+
+// Default cutoff depth for splitting off subtrees
+#define PAR_SPLIT_DEPTH 8
+
+// Index of the calling thread's deque (0 is the thread that started the
+// search)
+static thread_local int worker_id = 0;
+
+Par_Brancher::Par_Brancher(int threads)
+:num_threads(threads),
+ split_depth(PAR_SPLIT_DEPTH),
+ best(0)
+{
+  if (num_threads <= 0) num_threads = thread::hardware_concurrency();
+  if (num_threads <= 0) num_threads = 1;
+  par_imp = 1;
+}
+
+int Par_Brancher::par_init(Graph &g, Graph::Vertices &maximum_clique) const
+{
+  int i;
+
+  // Memoize every row's degree now, so that threads only read the graph
+  Graph::Vertices all(g);
+  all.fill();
+  Graph::Vertices::Vex_ptr vp(all);
+  for (; !vp.end(); ++vp) g.degree(*vp);
+
+  best = new Graph::Vertices(maximum_clique);
+  best_size = maximum_clique.size();
+  pending = 0;
+  idle = 0;
+  done = 0;
+  worker_id = 0;
+  for (i=0; i<num_threads; ++i) queues.push_back(new Task_Queue);
+  for (i=1; i<num_threads; ++i)
+    helpers.push_back(thread(&Par_Brancher::helper, this, i));
+
+  // This thread searches from the root, handing out subtrees as it goes
+  return RUN_AFTER_INIT;
+}
+
+int Par_Brancher::par_find_mcl(Graph::Vertices &mygraph,
+                               Graph::Vertices &maximum_clique,
+                               Graph::Vertices *current_clique, int depth)
+                                                                       const
+{
+  share_bound(maximum_clique);
+
+  // Nothing in this subtree can beat the best clique of any thread
+  if (mygraph.size() + current_clique->size() <=
+                          best_size.load(memory_order_relaxed)) return CONT_SEARCH;
+
+  if (depth < split_depth && idle.load(memory_order_relaxed) > 0)
+  {
+    Task_Queue *q = queues[worker_id];
+    lock_guard<mutex> guard(q->lock);
+    if ((int)q->tasks.size() < idle.load(memory_order_relaxed))
+    {
+      ++pending;
+      q->tasks.push_back(new Task(mygraph, *current_clique, depth));
+      return CONT_SEARCH;
+    }
+  }
+
+  find_mcl(mygraph, maximum_clique, current_clique, depth);
+  return CONT_SEARCH;
+}
+
+int Par_Brancher::par_checkin(Graph::Vertices &mygraph,
+                              Graph::Vertices &maximum_clique,
+                              Graph::Vertices *current_clique, int depth) const
+{
+  share_bound(maximum_clique);
+  return CONT_SEARCH;
+}
+
+void Par_Brancher::par_finish(Graph::Vertices &maximum_clique) const
+{
+  int i;
+
+  // Help with the remaining subtrees, then stop the other threads
+  work(0, maximum_clique, 1);
+  done = 1;
+  for (i=0; i<(int)helpers.size(); ++i) helpers[i].join();
+  helpers.clear();
+
+  share_bound(maximum_clique);
+  for (i=0; i<(int)queues.size(); ++i) delete queues[i];
+  queues.clear();
+  delete best;
+  best = 0;
+}
+
+void Par_Brancher::helper(int id) const
+{
+  worker_id = id;
+
+  best_lock.lock();
+  Graph::Vertices maximum_clique(*best);
+  best_lock.unlock();
+
+  work(id, maximum_clique, 0);
+  share_bound(maximum_clique);
+  report_thread_stats();
+}
+
+// Run subtrees until the search is done (until_done) or told to stop
+void Par_Brancher::work(int id, Graph::Vertices &maximum_clique,
+                                                       bool until_done) const
+{
+  bool waiting = 0;
+  Task *t;
+
+  while (1)
+  {
+    if ((t = get_task(id)) != 0)
+    {
+      if (waiting)
+      {
+        --idle;
+        waiting = 0;
+      }
+      share_bound(maximum_clique);
+      if (t->graph.size() + t->clique.size() > maximum_clique.size())
+                          find_mcl(t->graph, maximum_clique, &t->clique, t->depth);
+      share_bound(maximum_clique);
+      delete t;
+      --pending;
+      continue;
+    }
+
+    if (!waiting)
+    {
+      ++idle;
+      waiting = 1;
+    }
+    if (until_done ? pending.load() == 0 : done.load()) break;
+    this_thread::yield();
+  }
+  if (waiting) --idle;
+}
+
+// Newest task of this thread, or else the oldest task of another
+Par_Brancher::Task *Par_Brancher::get_task(int id) const
+{
+  int i;
+  Task *t = 0;
+
+  for (i=0; i<num_threads && t == 0; ++i)
+  {
+    Task_Queue *q = queues[(id + i) % num_threads];
+    lock_guard<mutex> guard(q->lock);
+    if (q->tasks.empty()) continue;
+    if (i == 0)
+    {
+      t = q->tasks.back();
+      q->tasks.pop_back();
+    }
+    else
+    {
+      t = q->tasks.front();
+      q->tasks.pop_front();
+    }
+  }
+  return t;
+}
+
+// Publish this thread's clique if it is the best so far, or catch up with
+// a better one found by another thread
+void Par_Brancher::share_bound(Graph::Vertices &maximum_clique) const
+{
+  int size = maximum_clique.size();
+  int global = best_size.load(memory_order_acquire);
+
+  if (size == global) return;
+  lock_guard<mutex> guard(best_lock);
+  if (size > best->size())
+  {
+    best->clear();
+    best->insert(maximum_clique);
+    best_size.store(size, memory_order_release);
+  }
+  else if (size < best->size())
+  {
+    maximum_clique.clear();
+    maximum_clique.insert(*best);
+  }
+}
@@ -0,0 +1,85 @@
+// Shared-memory parallel branching
+// A Brancher that searches with several threads, built on the Brancher's
+// parallel hooks.  Each thread keeps a deque of search subtrees.  While
+// some thread is idle, subtrees above a cutoff depth are pushed on the
+// owner's deque instead of being searched in place; the owner pops its
+// newest subtree and idle threads steal the oldest (and so largest)
+// subtree of another thread.  The size of the best clique found so far is
+// an atomic bound that every thread reads without locking, both to prune
+// subtrees and to catch up with cliques found elsewhere.
+//
+// The maximum clique size found is the same as for the serial Brancher,
+// but when there are several maximum cliques, which one is returned can
+// depend on thread timing.  Interleaved preprocessors must not be used,
+// since they modify the graph during the search.
+
+#ifndef _PAR_BRANCHER_H
+#define _PAR_BRANCHER_H 1
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+#include "Brancher.h"
+using namespace std;
+
+class Par_Brancher : public Brancher
+{
+  // A subtree of the search waiting to be run
+  struct Task
+  {
+    Graph::Vertices graph;
+    Graph::Vertices clique;
+    int depth;
+
+    Task(const Graph::Vertices &g, const Graph::Vertices &c, int d)
+    :graph(g), clique(c), depth(d) {}
+  };
+
+  struct Task_Queue
+  {
+    mutex lock;
+    deque<Task *> tasks;
+  };
+
+  int num_threads;
+  int split_depth;
+
+  // Search state shared by the threads of one run
+  mutable vector<Task_Queue *> queues;
+  mutable vector<thread> helpers;
+  mutable atomic<int> best_size;  // Size of *best
+  mutable mutex best_lock;        // Guards *best
+  mutable Graph::Vertices *best;
+  mutable atomic<long> pending;   // Tasks queued or running
+  mutable atomic<int> idle;       // Threads looking for work
+  mutable atomic<bool> done;
+
+  public:
+  // num_threads <= 0 uses every hardware thread
+  Par_Brancher(int num_threads = 0);
+
+  // Subtrees more than this deep in the search tree are never split off
+  void set_split_depth(int d) {split_depth = d;}
+  int threads() const {return num_threads;}
+
+  protected:
+  int par_init(Graph &g, Graph::Vertices &maximum_clique) const;
+  int par_find_mcl(Graph::Vertices &mygraph, Graph::Vertices &maximum_clique,
+                   Graph::Vertices *current_clique, int depth) const;
+  int par_checkin(Graph::Vertices &mygraph, Graph::Vertices &maximum_clique,
+                  Graph::Vertices *current_clique, int depth) const;
+  void par_finish(Graph::Vertices &maximum_clique) const;
+
+  private:
+  void helper(int id) const;
+  void work(int id, Graph::Vertices &maximum_clique, bool until_done) const;
+  Task *get_task(int id) const;
+  void share_bound(Graph::Vertices &maximum_clique) const;
+
+  Par_Brancher(const Par_Brancher &);
+  Par_Brancher &operator=(const Par_Brancher &);
+};
+
+#endif
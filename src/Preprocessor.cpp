@@ -1,4 +1,5 @@
 #include "Preprocessor.h"
+#include "Search_Stats.h"
 
 bool Preprocessor::operator() (Graph &mygraph, int min_clique_size, int depth)
 {
@@ -48,10 +49,8 @@ bool Preprocessor::operator() (Graph::Vertices &mygraph, int min_clique_size,
 
 bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
           const Clique_Test &test_fun, const Candidate_Manager *parent_cand_man,
-                                                    basic_tree *eliminated_sets)
+                                      basic_tree *eliminated_sets, int depth)
 {
-  static int depth = 0;
-  // if (depth == 1) cerr << ++counter << endl;
   if (level < 0) return 1;
   if (level == 0) return test_fun(mygraph, min_clique_size);
   depth++;
@@ -59,6 +58,7 @@ bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
   int cand;
   int num_failures = 0;
   Graph *base_graph = mygraph.graph();
+  Search_Stats removed;
 
   Candidate_Manager *cand_man = parent_cand_man->create();
   cand_man->init(&mygraph);
@@ -74,9 +74,12 @@ bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
     // level > 1.
     if (!test_fun.need_subgraph())
     {
+      // A node cand dominates is only in cliques that cand could take its
+      // place in, so it goes with cand
       if (test_fun(mygraph, min_clique_size, cand))
       {
         mygraph.remove(cand);
+        removed.dominated += mygraph.remove_dominated(cand);
         eliminated_sets->add_child(cand);
         num_failures = 0;
         continue;
@@ -96,6 +99,7 @@ bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
     if (test_fun.need_subgraph() && test_fun(subgraph, min_clique_size))
     {
       mygraph.remove(cand);
+      removed.dominated += mygraph.remove_dominated(cand);
       eliminated_sets->add_child(cand);
       num_failures = 0;
       continue;
@@ -111,9 +115,10 @@ bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
 
       // prep called successfully, remove node and prune tree at the node.
       if (prep(subgraph, min_clique_size, level-1, giveup, test_fun, cand_man,
-                                                 eliminated_sets->down(cand)))
+                                          eliminated_sets->down(cand), depth))
       {
         mygraph.remove(cand);
+        removed.dominated += mygraph.remove_dominated(cand);
         eliminated_sets->down(cand)->delete_all_children();
         num_failures = 0;
       }
@@ -157,6 +162,6 @@ bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
       }
     }
   }
-  depth--;
+  report_search_stats(removed);
   return test_fun(mygraph, min_clique_size);
 }
@@ -21,8 +21,11 @@
 #include "Candidate_Manager.h"
 using namespace std;
 
+// depth is the number of enclosing prep calls (a parameter rather than a
+// static, so that separate threads can preprocess at the same time)
 bool prep(Graph::Vertices &mygraph, int min_clique_size, int level, int giveup,
-          const Clique_Test &, const Candidate_Manager *, basic_tree *);
+          const Clique_Test &, const Candidate_Manager *, basic_tree *,
+                                                               int depth = 0);
 
 class Preprocessor
 {
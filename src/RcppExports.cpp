@@ -16,6 +16,49 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// handle_maximum_clique
+StringVector handle_maximum_clique(SEXP handle);
+RcppExport SEXP _cliqueR_handle_maximum_clique(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(handle_maximum_clique(handle));
+    return rcpp_result_gen;
+END_RCPP
+}
+// set_search_threads
+int set_search_threads(int threads);
+RcppExport SEXP _cliqueR_set_search_threads(SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(set_search_threads(threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// set_search_dominance
+bool set_search_dominance(int dominance);
+RcppExport SEXP _cliqueR_set_search_dominance(SEXP dominanceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type dominance(dominanceSEXP);
+    rcpp_result_gen = Rcpp::wrap(set_search_dominance(dominance));
+    return rcpp_result_gen;
+END_RCPP
+}
+// search_stats
+List search_stats();
+RcppExport SEXP _cliqueR_search_stats() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(search_stats());
+    return rcpp_result_gen;
+END_RCPP
+}
 // find_paracliques
 std::vector<std::vector<std::string> > find_paracliques(std::string filename, double igf, int min_mc_size, int min_pc_size, int max_num_pcs);
 RcppExport SEXP _cliqueR_find_paracliques(SEXP filenameSEXP, SEXP igfSEXP, SEXP min_mc_sizeSEXP, SEXP min_pc_sizeSEXP, SEXP max_num_pcsSEXP) {
@@ -31,12 +74,99 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// handle_find_paracliques
+std::vector<std::vector<std::string> > handle_find_paracliques(SEXP handle, double igf, int min_mc_size, int min_pc_size, int max_num_pcs);
+RcppExport SEXP _cliqueR_handle_find_paracliques(SEXP handleSEXP, SEXP igfSEXP, SEXP min_mc_sizeSEXP, SEXP min_pc_sizeSEXP, SEXP max_num_pcsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    Rcpp::traits::input_parameter< double >::type igf(igfSEXP);
+    Rcpp::traits::input_parameter< int >::type min_mc_size(min_mc_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type min_pc_size(min_pc_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type max_num_pcs(max_num_pcsSEXP);
+    rcpp_result_gen = Rcpp::wrap(handle_find_paracliques(handle, igf, min_mc_size, min_pc_size, max_num_pcs));
+    return rcpp_result_gen;
+END_RCPP
+}
+// check_graph_file
+Rcpp::List check_graph_file(std::string filename, bool repair, std::string repaired, bool load);
+RcppExport SEXP _cliqueR_check_graph_file(SEXP filenameSEXP, SEXP repairSEXP, SEXP repairedSEXP, SEXP loadSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type filename(filenameSEXP);
+    Rcpp::traits::input_parameter< bool >::type repair(repairSEXP);
+    Rcpp::traits::input_parameter< std::string >::type repaired(repairedSEXP);
+    Rcpp::traits::input_parameter< bool >::type load(loadSEXP);
+    rcpp_result_gen = Rcpp::wrap(check_graph_file(filename, repair, repaired, load));
+    return rcpp_result_gen;
+END_RCPP
+}
+// edges_graph_handle
+SEXP edges_graph_handle(SEXP from, SEXP to);
+RcppExport SEXP _cliqueR_edges_graph_handle(SEXP fromSEXP, SEXP toSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type from(fromSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type to(toSEXP);
+    rcpp_result_gen = Rcpp::wrap(edges_graph_handle(from, to));
+    return rcpp_result_gen;
+END_RCPP
+}
+// adjacency_graph_handle
+SEXP adjacency_graph_handle(SEXP adj, std::vector<std::string> labels);
+RcppExport SEXP _cliqueR_adjacency_graph_handle(SEXP adjSEXP, SEXP labelsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type adj(adjSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type labels(labelsSEXP);
+    rcpp_result_gen = Rcpp::wrap(adjacency_graph_handle(adj, labels));
+    return rcpp_result_gen;
+END_RCPP
+}
+// load_graph_handle
+SEXP load_graph_handle(std::string filename);
+RcppExport SEXP _cliqueR_load_graph_handle(SEXP filenameSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type filename(filenameSEXP);
+    rcpp_result_gen = Rcpp::wrap(load_graph_handle(filename));
+    return rcpp_result_gen;
+END_RCPP
+}
+// write_graph_snapshot
+std::vector<std::string> write_graph_snapshot(std::string filename, std::string snapshot, int dense);
+RcppExport SEXP _cliqueR_write_graph_snapshot(SEXP filenameSEXP, SEXP snapshotSEXP, SEXP denseSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type filename(filenameSEXP);
+    Rcpp::traits::input_parameter< std::string >::type snapshot(snapshotSEXP);
+    Rcpp::traits::input_parameter< int >::type dense(denseSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_graph_snapshot(filename, snapshot, dense));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 RcppExport SEXP R_maximal_clique(SEXP, SEXP, SEXP, SEXP);
 
 static const R_CallMethodDef CallEntries[] = {
     {"_cliqueR_maximum_clique", (DL_FUNC) &_cliqueR_maximum_clique, 1},
+    {"_cliqueR_handle_maximum_clique", (DL_FUNC) &_cliqueR_handle_maximum_clique, 1},
+    {"_cliqueR_set_search_threads", (DL_FUNC) &_cliqueR_set_search_threads, 1},
+    {"_cliqueR_set_search_dominance", (DL_FUNC) &_cliqueR_set_search_dominance, 1},
+    {"_cliqueR_search_stats", (DL_FUNC) &_cliqueR_search_stats, 0},
     {"_cliqueR_find_paracliques", (DL_FUNC) &_cliqueR_find_paracliques, 5},
+    {"_cliqueR_handle_find_paracliques", (DL_FUNC) &_cliqueR_handle_find_paracliques, 5},
+    {"_cliqueR_check_graph_file", (DL_FUNC) &_cliqueR_check_graph_file, 4},
+    {"_cliqueR_edges_graph_handle", (DL_FUNC) &_cliqueR_edges_graph_handle, 2},
+    {"_cliqueR_adjacency_graph_handle", (DL_FUNC) &_cliqueR_adjacency_graph_handle, 2},
+    {"_cliqueR_load_graph_handle", (DL_FUNC) &_cliqueR_load_graph_handle, 1},
+    {"_cliqueR_write_graph_snapshot", (DL_FUNC) &_cliqueR_write_graph_snapshot, 3},
     {"R_maximal_clique", (DL_FUNC) &R_maximal_clique, 4},
     {NULL, NULL, 0}
 };
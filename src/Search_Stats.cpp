@@ -0,0 +1,21 @@
+#include <atomic>
+#include "Search_Stats.h"
+using namespace std;
+
+static atomic<long> total_branches(0);
+static atomic<long> total_dominated(0);
+
+void report_search_stats(Search_Stats &s)
+{
+  total_branches += s.branches;
+  total_dominated += s.dominated;
+  s = Search_Stats();
+}
+
+Search_Stats take_search_stats()
+{
+  Search_Stats s;
+  s.branches = total_branches.exchange(0);
+  s.dominated = total_dominated.exchange(0);
+  return s;
+}
@@ -0,0 +1,30 @@
+// Search statistics
+// Counts of search tree nodes (calls of a branching function) and of
+// candidates removed because another candidate dominates them (see
+// Graph::Vertices::remove_dominated), summed over the searches of the
+// process.  Each engine counts in a Search_Stats of its own and adds it to
+// the totals once its search ends, so threads never share a counter.
+
+#ifndef _SEARCH_STATS_H
+#define _SEARCH_STATS_H 1
+
+struct Search_Stats
+{
+  long branches;
+  long dominated;
+
+  Search_Stats() :branches(0), dominated(0) {}
+  void add(const Search_Stats &s)
+  {
+    branches += s.branches;
+    dominated += s.dominated;
+  }
+};
+
+// Add s to the totals and clear it
+void report_search_stats(Search_Stats &s);
+
+// Totals since the last call, which clears them
+Search_Stats take_search_stats();
+
+#endif
@@ -0,0 +1,279 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Snapshot.h"
+#include "Sparse_Graph.h"
+#include "Edge_Validator.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+static void snapshot_error(const string &file_name, const char *what)
+{
+  cerr << "Error - " << file_name << " is not a valid graph snapshot ("
+       << what << ")." << endl;
+  exit(EXIT_FAILURE);
+}
+
+Snapshot::Snapshot(const string &snapshot_file)
+:file_name(snapshot_file),
+ file(snapshot_file),
+ hdr((const snapshot_header *)file.begin())
+{
+  uint64_t n, m, i, j, v;
+  const uint64_t *index;
+  const uint32_t *adj;
+  const char *labels;
+
+  if (file.size() < sizeof(snapshot_header) ||
+      memcmp(hdr->magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) != 0)
+    snapshot_error(file_name, "bad magic");
+  if (hdr->version != SNAPSHOT_VERSION)
+    snapshot_error(file_name, "unsupported version");
+  if (hdr->byte_order != SNAPSHOT_BYTE_ORDER)
+    snapshot_error(file_name, "written on a machine with another byte order");
+  if (hdr->file_bytes != file.size())
+    snapshot_error(file_name, "truncated");
+
+  // Every section must lie inside the file.  Counts and offsets are bounded
+  // by the file size first, so that the sums below cannot wrap.
+  n = hdr->num_nodes;
+  m = hdr->num_edges;
+  if (n > 0x7fffffff || m > hdr->file_bytes / (2 * sizeof(uint32_t)) ||
+      hdr->label_index_off > hdr->file_bytes ||
+      hdr->label_data_off > hdr->file_bytes ||
+      hdr->degree_off > hdr->file_bytes ||
+      hdr->csr_index_off > hdr->file_bytes ||
+      hdr->csr_adj_off > hdr->file_bytes ||
+      (hdr->flags & SNAPSHOT_DENSE &&
+       (hdr->dense_off > hdr->file_bytes ||
+        hdr->dense_bytes > hdr->file_bytes)))
+    snapshot_error(file_name, "bad section table");
+  if (hdr->label_index_off + (n + 1) * sizeof(uint64_t) > hdr->label_data_off ||
+      hdr->label_data_off > hdr->degree_off ||
+      hdr->degree_off + n * sizeof(uint32_t) > hdr->csr_index_off ||
+      hdr->csr_index_off + (n + 1) * sizeof(uint64_t) > hdr->csr_adj_off ||
+      hdr->csr_adj_off + 2 * m * sizeof(uint32_t) > hdr->file_bytes ||
+      (hdr->flags & SNAPSHOT_DENSE &&
+       hdr->dense_off + hdr->dense_bytes > hdr->file_bytes))
+    snapshot_error(file_name, "bad section table");
+
+  // Every label is NUL-terminated inside its own slot of the label data
+  index = section<uint64_t>(hdr->label_index_off);
+  labels = section<char>(hdr->label_data_off);
+  if (index[0] != 0 || index[n] > hdr->degree_off - hdr->label_data_off)
+    snapshot_error(file_name, "bad label table");
+  for (i=0; i<n; ++i)
+    if (index[i] >= index[i+1] || labels[index[i+1] - 1] != '\0')
+      snapshot_error(file_name, "bad label table");
+
+  // Rows are sorted lists of other nodes, the degrees are their lengths and
+  // every edge is listed from both ends.  Rows are checked in node order, so
+  // the entries of row v below v are met in the order they are listed;
+  // next[v] is the first of them not yet matched.
+  index = csr_index();
+  adj = csr_adj();
+  if (index[0] != 0 || index[n] != 2 * m)
+    snapshot_error(file_name, "bad adjacency");
+  for (i=0; i<n; ++i)
+    if (index[i] > index[i+1] || degree(i) != index[i+1] - index[i])
+      snapshot_error(file_name, "bad adjacency");
+  vector<uint64_t> next(index, index + n);
+  for (i=0; i<n; ++i)
+  {
+    if (next[i] < index[i+1] && adj[next[i]] < i)
+      snapshot_error(file_name, "adjacency is not symmetric");
+    for (j=index[i]; j<index[i+1]; ++j)
+    {
+      v = adj[j];
+      if (v >= n || v == i || (j > index[i] && adj[j-1] >= v))
+        snapshot_error(file_name, "bad adjacency");
+      if (v < i) continue;
+      if (next[v] == index[v+1] || adj[next[v]] != i)
+        snapshot_error(file_name, "adjacency is not symmetric");
+      ++next[v];
+    }
+  }
+}
+
+const unsigned long *Snapshot::dense_rows(int row_uls) const
+{
+  if (!(hdr->flags & SNAPSHOT_DENSE) ||
+      hdr->word_bytes != sizeof(unsigned long) ||
+      hdr->row_words != (uint64_t)row_uls ||
+      hdr->dense_bytes != (uint64_t)row_uls * sizeof(unsigned long) * size())
+    return 0;
+  return section<unsigned long>(hdr->dense_off);
+}
+
+unsigned long *Snapshot::map_dense_rows(int row_uls) const
+{
+#if defined(_WIN32)
+  return 0;
+#else
+  void *p;
+  int fd;
+
+  if (dense_rows(row_uls) == 0 || hdr->dense_bytes == 0 ||
+      hdr->dense_off % sysconf(_SC_PAGESIZE) != 0) return 0;
+
+  fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) return 0;
+  p = mmap(0, hdr->dense_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                                                          hdr->dense_off);
+  close(fd);
+  return (p == MAP_FAILED) ? 0 : (unsigned long *)p;
+#endif
+}
+
+void Snapshot::unmap_dense_rows(unsigned long *rows, size_t bytes)
+{
+#if !defined(_WIN32)
+  munmap(rows, bytes);
+#endif
+}
+
+bool is_snapshot(const string &file_name)
+{
+  char magic[SNAPSHOT_MAGIC_LEN];
+  ifstream input(file_name.c_str(), ios::in | ios::binary);
+
+  if (!input.read(magic, SNAPSHOT_MAGIC_LEN)) return 0;
+  return memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) == 0;
+}
+
+// Pad the output with zeros up to the next section boundary
+static uint64_t next_section(ofstream &out, uint64_t pos)
+{
+  static const char zeros[4096] = {0};
+  uint64_t next = (pos + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+  uint64_t gap = next - pos;
+
+  while (gap > 0)
+  {
+    uint64_t len = gap < sizeof(zeros) ? gap : sizeof(zeros);
+    out.write(zeros, len);
+    gap -= len;
+  }
+  return next;
+}
+
+void write_snapshot(Edge_List &el, const string &snapshot_file, int dense)
+{
+  int i;
+  uint64_t pos;
+  const int *p;
+  snapshot_header hdr;
+  Sparse_Graph sg;
+  vector<uint64_t> index;
+  vector<uint32_t> values;
+
+  sg.build(el.labels, el.edges);
+  int n = sg.size();
+  if (dense < 0) dense = !use_sparse_backend(n, sg.esize());
+
+  ofstream out(snapshot_file.c_str(), ios::out | ios::binary | ios::trunc);
+  if (!out)
+  {
+    cerr << "Error - Unable to open file " << snapshot_file << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN);
+  hdr.version = SNAPSHOT_VERSION;
+  hdr.byte_order = SNAPSHOT_BYTE_ORDER;
+  hdr.num_nodes = n;
+  hdr.num_edges = sg.esize();
+  out.write((const char *)&hdr, sizeof(hdr));  // Rewritten at the end
+  pos = sizeof(hdr);
+
+  // Labels
+  pos = hdr.label_index_off = next_section(out, pos);
+  index.assign(1, 0);
+  for (i=0; i<n; ++i) index.push_back(index.back() + sg.label(i).size() + 1);
+  out.write((const char *)&index[0], index.size() * sizeof(uint64_t));
+  pos += index.size() * sizeof(uint64_t);
+
+  pos = hdr.label_data_off = next_section(out, pos);
+  for (i=0; i<n; ++i)
+  {
+    string l = sg.label(i);
+    out.write(l.c_str(), l.size() + 1);
+  }
+  pos += index.back();
+
+  // Degrees
+  pos = hdr.degree_off = next_section(out, pos);
+  values.resize(n);
+  for (i=0; i<n; ++i) values[i] = sg.degree(i);
+  if (n > 0) out.write((const char *)&values[0], n * sizeof(uint32_t));
+  pos += n * sizeof(uint32_t);
+
+  // CSR
+  pos = hdr.csr_index_off = next_section(out, pos);
+  index.assign(1, 0);
+  for (i=0; i<n; ++i) index.push_back(index.back() + sg.degree(i));
+  out.write((const char *)&index[0], index.size() * sizeof(uint64_t));
+  pos += index.size() * sizeof(uint64_t);
+
+  pos = hdr.csr_adj_off = next_section(out, pos);
+  for (i=0; i<n; ++i)
+  {
+    values.assign(sg.nbrs_begin(i), sg.nbrs_end(i));
+    if (!values.empty())
+      out.write((const char *)&values[0], values.size() * sizeof(uint32_t));
+  }
+  pos += index.back() * sizeof(uint32_t);
+
+  // Dense rows, one Graph row at a time
+  if (dense && n > 0)
+  {
+    int row_uls = Graph::row_words_for(n);
+    vector<unsigned long> row(row_uls);
+    bitarray view;
+
+    hdr.flags |= SNAPSHOT_DENSE;
+    hdr.word_bytes = sizeof(unsigned long);
+    hdr.row_words = row_uls;
+    pos = hdr.dense_off = next_section(out, pos);
+    view.attach(&row[0], n);
+    for (i=0; i<n; ++i)
+    {
+      view.reset();
+      for (p = sg.nbrs_begin(i); p != sg.nbrs_end(i); ++p) view.set(*p);
+      out.write((const char *)&row[0], row_uls * sizeof(unsigned long));
+    }
+    hdr.dense_bytes = (uint64_t)n * row_uls * sizeof(unsigned long);
+    pos += hdr.dense_bytes;
+  }
+
+  hdr.file_bytes = pos;
+  out.seekp(0);
+  out.write((const char *)&hdr, sizeof(hdr));
+  out.close();
+  if (!out)
+  {
+    cerr << "Error - Unable to write file " << snapshot_file << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// Checks the edge list while loading it; nothing is written if it has
+// problems, which are returned instead.
+// [[Rcpp::export]]
+std::vector<std::string> write_graph_snapshot(std::string filename,
+                                              std::string snapshot, int dense)
+{
+  Edge_List el;
+  Edge_List_Check check;
+
+  load_edge_list(filename, el);
+  if (check_edge_list(el, check)) write_snapshot(el, snapshot, dense);
+  return check.problems;
+}
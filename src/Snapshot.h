@@ -0,0 +1,68 @@
+// Graph snapshot library
+// A snapshot is an edge list that has been parsed once and saved in a
+// versioned binary format (see snapshot_format.h): the label table,
+// precomputed degrees, CSR adjacency and, for graphs small enough for the
+// dense engines, Graph's bit matrix itself.  Loading a snapshot maps the
+// file instead of parsing it, and a dense Graph can take its matrix
+// straight from a private (copy-on-write) mapping of the file, so repeated
+// queries on the same network cost almost nothing to start up.
+//
+// Every entry point that accepts an edge list file also accepts a snapshot;
+// files are told apart by the magic bytes at the start.
+
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H 1
+
+#include <string>
+#include "snapshot_format.h"
+#include "Edge_Loader.h"
+using namespace std;
+
+class Snapshot
+{
+  string file_name;
+  Mapped_File file;
+  const snapshot_header *hdr;
+
+  template <class T> const T *section(uint64_t off) const
+                                    {return (const T *)(file.begin() + off);}
+
+  public:
+  // Map and validate a snapshot file, down to its labels and adjacency, in
+  // linear time.  Exits on a malformed file.
+  Snapshot(const string &snapshot_file);
+
+  // Accessor methods
+  int size() const {return (int)hdr->num_nodes;}
+  long esize() const {return (long)hdr->num_edges;}
+  const char *label(int n) const
+        {return section<char>(hdr->label_data_off) +
+                section<uint64_t>(hdr->label_index_off)[n];}
+  unsigned degree(int n) const {return section<uint32_t>(hdr->degree_off)[n];}
+  const uint64_t *csr_index() const
+                               {return section<uint64_t>(hdr->csr_index_off);}
+  const uint32_t *csr_adj() const {return section<uint32_t>(hdr->csr_adj_off);}
+
+  // Dense rows, if present and laid out with row_uls words per row
+  const unsigned long *dense_rows(int row_uls) const;
+
+  // Map the dense rows privately (copy-on-write) so a Graph can use them as
+  // its own matrix; release with unmap_dense_rows.  Returns 0 if the rows
+  // are unusable or the platform cannot map them.
+  unsigned long *map_dense_rows(int row_uls) const;
+  static void unmap_dense_rows(unsigned long *rows, size_t bytes);
+
+  private:
+  Snapshot(const Snapshot &);
+  Snapshot &operator=(const Snapshot &);
+};
+
+// True if the file starts with the snapshot magic bytes
+bool is_snapshot(const string &file_name);
+
+// Write a snapshot of a loaded edge list (which is consumed).  dense is 1 to
+// include Graph's bit matrix, 0 to leave it out, or -1 to include it unless
+// the graph would use the sparse backend.
+void write_snapshot(Edge_List &el, const string &snapshot_file, int dense = -1);
+
+#endif
@@ -0,0 +1,306 @@
+#include "Sparse_Graph.h"
+#include "Edge_Loader.h"
+#include "Snapshot.h"
+#include "Core_Decomposition.h"
+
+// Sparse backend thresholds.  Below SPARSE_MIN_NODES the dense matrix is
+// at most 32 MB and always preferred, since every engine works on it.
+#define SPARSE_MIN_NODES 16384
+#define SPARSE_MAX_FRACTION 16  // CSR must be under 1/16 of the dense size
+
+// Number of seed vertices tried by sparse_greedy_clique
+#define SPARSE_GREEDY_SEEDS 64
+
+// Candidate sets at most this large are scored exactly in the greedy
+// heuristic; larger ones fall back to whole-graph degree.
+#define SPARSE_GREEDY_EXACT 512
+
+Sparse_Graph::Sparse_Graph(string &graph_file)
+:num_nodes(0),
+ num_edges(0),
+ offsets(1, 0)
+{
+  if (is_snapshot(graph_file))
+  {
+    Snapshot snap(graph_file);
+    build(snap);
+    return;
+  }
+
+  Edge_List el;
+  load_edge_list(graph_file, el);
+  build(el.labels, el.edges);
+}
+
+void Sparse_Graph::build(const Snapshot &snap)
+{
+  int i;
+
+  num_nodes = snap.size();
+  num_edges = snap.esize();
+  offsets.assign(snap.csr_index(), snap.csr_index() + num_nodes + 1);
+  adj.assign(snap.csr_adj(), snap.csr_adj() + offsets[num_nodes]);
+  nodes.resize(num_nodes);
+  node2num.clear();
+  for (i=0; i<num_nodes; ++i)
+  {
+    nodes[i] = snap.label(i);
+    if (nodes[i] != "") node2num[nodes[i]] = i;
+  }
+}
+
+void Sparse_Graph::build(vector<string> &labels,
+                         vector<pair<int, int> > &edge_list)
+{
+  int i, n;
+  long j, k;
+  vector<long> fill;
+
+  num_nodes = labels.size();
+  nodes.swap(labels);
+  node2num.clear();
+  for (i=0; i<num_nodes; ++i) if (nodes[i] != "") node2num[nodes[i]] = i;
+
+  // Count, then place both directions of every edge
+  offsets.assign(num_nodes + 1, 0);
+  for (j=0; j<(long)edge_list.size(); ++j)
+  {
+    if (edge_list[j].first == edge_list[j].second) continue;
+    ++offsets[edge_list[j].first + 1];
+    ++offsets[edge_list[j].second + 1];
+  }
+  for (i=0; i<num_nodes; ++i) offsets[i+1] += offsets[i];
+
+  adj.resize(offsets[num_nodes]);
+  fill.assign(offsets.begin(), offsets.end() - 1);
+  for (j=0; j<(long)edge_list.size(); ++j)
+  {
+    if (edge_list[j].first == edge_list[j].second) continue;
+    adj[fill[edge_list[j].first]++] = edge_list[j].second;
+    adj[fill[edge_list[j].second]++] = edge_list[j].first;
+  }
+  vector<pair<int, int> >().swap(edge_list);
+
+  // Sort rows and drop duplicate edges, compacting in place
+  k = 0;
+  for (n=0; n<num_nodes; ++n)
+  {
+    long begin = offsets[n], end = offsets[n+1];
+    sort(adj.begin() + begin, adj.begin() + end);
+    offsets[n] = k;
+    for (j=begin; j<end; ++j)
+    {
+      if (j > begin && adj[j] == adj[j-1]) continue;
+      adj[k++] = adj[j];
+    }
+  }
+  offsets[num_nodes] = k;
+  adj.resize(k);
+  num_edges = k / 2;
+}
+
+void read_graph_header(const string &graph_file, int &num_nodes,
+                                                 long &num_edges)
+{
+  if (is_snapshot(graph_file))
+  {
+    Snapshot snap(graph_file);
+    num_nodes = snap.size();
+    num_edges = snap.esize();
+    return;
+  }
+
+  ifstream input(graph_file.c_str());
+  if (!input)
+  {
+    cerr << "Error - Unable to open file " << graph_file << endl;
+    exit(EXIT_FAILURE);
+  }
+  num_nodes = 0;
+  num_edges = 0;
+  input >> num_nodes >> num_edges;
+  input.close();
+}
+
+bool use_sparse_backend(int num_nodes, long num_edges)
+{
+  double dense_bytes, sparse_bytes;
+
+  if (num_nodes < SPARSE_MIN_NODES) return 0;
+  dense_bytes = (double)num_nodes * (double)num_nodes / 8.0;
+  sparse_bytes = 2.0 * num_edges * sizeof(int) +
+                 (double)num_nodes * sizeof(long);
+  return sparse_bytes * SPARSE_MAX_FRACTION < dense_bytes;
+}
+
+int alive_degree(const Sparse_Graph &sg, const vector<char> &alive, int n)
+{
+  int deg = 0;
+  const int *p;
+
+  for (p = sg.nbrs_begin(n); p != sg.nbrs_end(n); ++p) if (alive[*p]) ++deg;
+  return deg;
+}
+
+int sparse_core_prune(const Sparse_Graph &sg, vector<char> &alive, int k)
+{
+  int n, u;
+  int num_left = 0;
+  const int *p;
+  vector<int> deg(sg.size(), 0);
+  vector<int> queue;
+
+  for (n=0; n<sg.size(); ++n) if (alive[n]) deg[n] = alive_degree(sg, alive, n);
+  for (n=0; n<sg.size(); ++n)
+  {
+    if (!alive[n]) continue;
+    if (deg[n] < k) {alive[n] = 0; queue.push_back(n);}
+    else ++num_left;
+  }
+
+  // Each removal can push neighbors below k; every edge is visited at most
+  // twice overall.
+  while (!queue.empty())
+  {
+    u = queue.back();
+    queue.pop_back();
+    for (p = sg.nbrs_begin(u); p != sg.nbrs_end(u); ++p)
+    {
+      if (!alive[*p]) continue;
+      if (--deg[*p] < k)
+      {
+        alive[*p] = 0;
+        queue.push_back(*p);
+        --num_left;
+      }
+    }
+  }
+
+  return num_left;
+}
+
+// Adjacency view of the alive subgraph, for peel
+class Sparse_Adj
+{
+  const Sparse_Graph &sg;
+  const vector<char> &alive_mask;
+
+  public:
+  Sparse_Adj(const Sparse_Graph &g, const vector<char> &alive)
+  :sg(g), alive_mask(alive) {}
+  int size() const {return sg.size();}
+  bool alive(int n) const {return alive_mask[n];}
+  int degree(int n) const {return alive_degree(sg, alive_mask, n);}
+  void nbrs(int n, vector<int> &dest) const
+  {
+    const int *p;
+
+    dest.clear();
+    for (p = sg.nbrs_begin(n); p != sg.nbrs_end(n); ++p)
+                                      if (alive_mask[*p]) dest.push_back(*p);
+  }
+};
+
+void sparse_core_order(const Sparse_Graph &sg, const vector<char> &alive,
+                                       vector<int> &order, vector<int> &core)
+{
+  peel(Sparse_Adj(sg, alive), order, core);
+}
+
+int sparse_greedy_clique(const Sparse_Graph &sg, const vector<char> &alive,
+                                                    vector<int> &clique)
+{
+  int i, n, s;
+  int score, best_score, best;
+  vector<int> order, cand, next_cand, current;
+  vector<int> deg(sg.size(), 0);
+  vector<int>::iterator c;
+
+  clique.clear();
+  for (n=0; n<sg.size(); ++n)
+  {
+    if (!alive[n]) continue;
+    deg[n] = alive_degree(sg, alive, n);
+    order.push_back(n);
+  }
+  if (order.empty()) return 0;
+  sort(order.begin(), order.end(), vector_sort_des(deg));
+
+  for (s=0; s<(int)order.size() && s<SPARSE_GREEDY_SEEDS; ++s)
+  {
+    // A seed of degree d can only give a clique of size d+1
+    if (deg[order[s]] + 1 <= (int)clique.size()) break;
+
+    current.assign(1, order[s]);
+    cand.clear();
+    for (const int *p = sg.nbrs_begin(order[s]); p != sg.nbrs_end(order[s]);
+                                                                           ++p)
+      if (alive[*p]) cand.push_back(*p);
+
+    while (!cand.empty())
+    {
+      // Pick the candidate with the most neighbors among the candidates
+      // (exact for small sets, otherwise approximated by degree)
+      best = -1;
+      best_score = -1;
+      for (c = cand.begin(); c != cand.end(); ++c)
+      {
+        if ((int)cand.size() <= SPARSE_GREEDY_EXACT)
+        {
+          score = 0;
+          for (i=0; i<(int)cand.size(); ++i)
+            if (sg.connected(*c, cand[i])) ++score;
+        }
+        else score = deg[*c];
+        if (score > best_score) {best_score = score; best = *c;}
+      }
+
+      current.push_back(best);
+      next_cand.clear();
+      set_intersection(cand.begin(), cand.end(), sg.nbrs_begin(best),
+                       sg.nbrs_end(best), back_inserter(next_cand));
+      cand.swap(next_cand);
+    }
+
+    if (current.size() > clique.size()) clique = current;
+  }
+
+  return clique.size();
+}
+
+Graph *build_dense_subgraph(const Sparse_Graph &sg, const vector<int> &keep)
+{
+  vector<int> sparse2dense(sg.size(), -1);
+  return build_dense_subgraph(sg, keep, sparse2dense);
+}
+
+Graph *build_dense_subgraph(const Sparse_Graph &sg, const vector<int> &keep,
+                                                   vector<int> &sparse2dense)
+{
+  int i, j;
+  int k = keep.size();
+  const int *p;
+  Graph *g = new Graph(0, max(1, k));
+
+  for (i=0; i<(int)keep.size(); ++i)
+                      sparse2dense[keep[i]] = g->create_new_node(sg.label(keep[i]));
+
+  // Scan short neighbor lists; look up pairs for hubs
+  for (i=0; i<k; ++i)
+  {
+    if (sg.degree(keep[i]) <= 8 * k)
+    {
+      for (p = sg.nbrs_begin(keep[i]); p != sg.nbrs_end(keep[i]); ++p)
+      {
+        if (sparse2dense[*p] > i) g->connect(i, sparse2dense[*p]);
+      }
+    }
+    else
+    {
+      for (j=i+1; j<k; ++j) if (sg.connected(keep[i], keep[j])) g->connect(i, j);
+    }
+  }
+
+  for (i=0; i<k; ++i) sparse2dense[keep[i]] = -1;
+  return g;
+}
@@ -0,0 +1,101 @@
+// Sparse graph library
+// A compressed sparse row (CSR) adjacency structure for graphs that are far
+// too large for Graph's dense bit matrix (a 500,000 vertex network needs
+// ~31 GB as a bit matrix but only a few MB as CSR).  Sparse_Graph is
+// read-only once built; whole-graph phases such as degree and core pruning
+// and the greedy heuristic work on it directly with a separate "alive" mask,
+// and only the small subproblem that survives is turned into a dense Graph
+// (see build_dense_subgraph) for the exact search.
+
+#ifndef _SPARSE_GRAPH_H
+#define _SPARSE_GRAPH_H 1
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "Graph.h"
+using namespace std;
+
+class Snapshot;
+
+class Sparse_Graph
+{
+  int num_nodes;
+  long num_edges;
+  vector<long> offsets;  // Neighbors of n are adj[offsets[n]..offsets[n+1])
+  vector<int> adj;       // Sorted within each row
+
+  vector<string> nodes;  // Node number to name mapping
+  map<string, int> node2num;  // Node name to number mapping
+
+  const int *adj_data() const {return adj.empty() ? 0 : &adj[0];}
+
+  public:
+  // Constructors
+  Sparse_Graph() :num_nodes(0), num_edges(0), offsets(1, 0) {}
+  Sparse_Graph(string &graph_file);
+
+  // Build from an edge list over nodes 0..n-1 with the given labels.
+  // Self loops and duplicate edges are dropped.  edge_list is consumed.
+  void build(vector<string> &labels, vector<pair<int, int> > &edge_list);
+  void build(const Snapshot &);
+
+  // Accessor methods
+  int size() const {return num_nodes;}
+  long esize() const {return num_edges;}
+  int degree(int n) const {return (int)(offsets[n+1] - offsets[n]);}
+  const int *nbrs_begin(int n) const {return adj_data() + offsets[n];}
+  const int *nbrs_end(int n) const {return adj_data() + offsets[n+1];}
+  bool connected(int n1, int n2) const
+                 {return binary_search(nbrs_begin(n1), nbrs_end(n1), n2);}
+  string label(int n) const {return nodes[n];}
+  int vertex(const string &n) const
+  {
+    map<string, int>::const_iterator i = node2num.find(n);
+    if (i == node2num.end()) return -1;
+    return i->second;
+  }
+};
+
+// Read the "<nodes> <edges>" header line of an edge list file, or the
+// counts stored in a snapshot
+void read_graph_header(const string &graph_file, int &num_nodes,
+                                                 long &num_edges);
+
+// Backend selection.  The sparse backend is used when the dense bit matrix
+// would be large and the CSR arrays would be a small fraction of its size.
+bool use_sparse_backend(int num_nodes, long num_edges);
+
+// Degree of n counting only alive neighbors
+int alive_degree(const Sparse_Graph &, const vector<char> &alive, int n);
+
+// Repeatedly remove (mark dead) alive vertices with fewer than k alive
+// neighbors, leaving the k-core of the alive subgraph.  O(n + m).
+// Returns the number of vertices left.
+int sparse_core_prune(const Sparse_Graph &, vector<char> &alive, int k);
+
+// Degeneracy ordering of the alive subgraph:  order lists the alive
+// vertices as they are peeled off by repeatedly removing one of least alive
+// degree, and core[n] is the core number of n (its degree when peeled).
+// A vertex has at most core[n] alive neighbors later in the order.  O(n + m).
+void sparse_core_order(const Sparse_Graph &, const vector<char> &alive,
+                                      vector<int> &order, vector<int> &core);
+
+// Greedy maximum clique heuristic on the alive subgraph.  Seeds from
+// high-degree vertices and extends greedily by sorted-list intersection.
+// Returns the clique size.
+int sparse_greedy_clique(const Sparse_Graph &, const vector<char> &alive,
+                                                   vector<int> &clique);
+
+// Build a dense Graph induced by the given Sparse_Graph vertices.  Node i of
+// the result corresponds to keep[i] and carries the same label.
+Graph *build_dense_subgraph(const Sparse_Graph &, const vector<int> &keep);
+
+// Same, for building many small subgraphs:  sparse2dense is scratch space
+// of sg.size() entries that must be all -1, and is left that way.
+Graph *build_dense_subgraph(const Sparse_Graph &, const vector<int> &keep,
+                                                  vector<int> &sparse2dense);
+
+#endif
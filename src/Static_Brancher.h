@@ -0,0 +1,214 @@
+// Compile-time specialized branching
+// The same search as Brancher::find_mcl, with the candidate manager, the
+// search order and the bound fixed as template parameters so that the
+// inner loop has no virtual calls, and with every per-depth vertex set and
+// candidate manager allocated once and reused.  Brancher hands its search
+// to one of these when its configuration allows (see Brancher::run_static);
+// searches that need interleaved or degree preprocessing, or the parallel
+// hooks, stay on the general loop.  Dominance pruning and the search
+// statistics work as in Brancher.
+
+#ifndef _STATIC_BRANCHER_H
+#define _STATIC_BRANCHER_H 1
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include "Graph.h"
+#include "Candidate_Manager.h"
+#include "color.h"
+#include "Search_Stats.h"
+using namespace std;
+
+// Bound policies:  the size a clique must beat to be of interest, and
+// whether the search is done.  limit, if positive, is known to bound the
+// clique size from above, so the search is done once it is reached.
+
+// Size of the best clique of this search
+struct Own_Bound
+{
+  int limit;
+
+  Own_Bound(int l = 0) :limit(l) {}
+  int operator() (int best_size) const {return best_size;}
+  bool done(int best_size) const {return limit > 0 && best_size >= limit;}
+};
+
+// Also the best clique of other searches, which only want cliques larger
+// than *bound - offset and may raise *bound at any time (see
+// find_mc_by_vertex)
+struct Shared_Bound
+{
+  const atomic<int> *bound;
+  int offset;
+  int limit;
+
+  Shared_Bound(const atomic<int> *b = 0, int o = 0, int l = 0)
+  :bound(b), offset(o), limit(l) {}
+  int operator() (int best_size) const
+            {return max(best_size, bound->load(memory_order_relaxed) - offset);}
+  bool done(int best_size) const
+                        {return limit > 0 && (*this)(best_size) >= limit;}
+};
+
+template <class Cand_Man, bool best_to_worst = true,
+          class Bound = Own_Bound>
+class Static_Brancher
+{
+  Bound bound;
+  Graph *g;
+  bool dominance;
+  Search_Stats stats;
+
+  // Search state of each depth
+  vector<Graph::Vertices *> sets;     // Candidates
+  vector<Graph::Vertices *> cliques;  // Current clique
+  vector<Cand_Man *> cand_mans;
+
+  public:
+  Static_Brancher(const Bound &b = Bound()) :bound(b), g(0), dominance(0) {}
+  ~Static_Brancher() {release();}
+
+  // Remove the candidates a node dominates once its branch is searched
+  // (best to worst search only; see Graph::Vertices::remove_dominated)
+  void set_dominance(bool d) {dominance = d;}
+
+  // Same as Brancher::operator()
+  int operator() (Graph &mygraph, Graph::Vertices &maximum_clique)
+  {
+    Graph::Vertices v(mygraph);
+    v.fill();
+    return (*this)(v, maximum_clique);
+  }
+  int operator() (Graph::Vertices &mygraph, Graph::Vertices &maximum_clique);
+
+  private:
+  void expand(int depth, Graph::Vertices &maximum_clique);
+  void reserve(int levels);
+  void release();
+  static void update(Graph::Vertices &m, const Graph::Vertices &c)
+  {
+    if (c.size() > m.size()) m.assign(c);
+  }
+
+  Static_Brancher(const Static_Brancher &);
+  Static_Brancher &operator=(const Static_Brancher &);
+};
+
+template <class Cand_Man, bool best_to_worst, class Bound>
+int Static_Brancher<Cand_Man, best_to_worst, Bound>::operator()
+                 (Graph::Vertices &mygraph, Graph::Vertices &maximum_clique)
+{
+  Bitset_Coloring coloring;
+  vector<int> nodes, colors;
+
+  if (g != mygraph.graph()) release();
+  g = mygraph.graph();
+
+  // Best to worst search goes one level deeper per clique node, and a
+  // clique has at most one node of each color.  Worst to best search can
+  // go deeper and grows the stack as needed.
+  if (best_to_worst) reserve(coloring.color(mygraph, nodes, colors) + 2);
+  else reserve(2);
+
+  sets[0]->assign(mygraph);
+  cliques[0]->clear();
+  expand(0, maximum_clique);
+  report_search_stats(stats);
+  return maximum_clique.size();
+}
+
+template <class Cand_Man, bool best_to_worst, class Bound>
+void Static_Brancher<Cand_Man, best_to_worst, Bound>::expand(int depth,
+                                          Graph::Vertices &maximum_clique)
+{
+  int cand;
+  Graph::Vertices &mygraph = *sets[depth];
+  Graph::Vertices &current_clique = *cliques[depth];
+  Cand_Man &cand_man = *cand_mans[depth];
+
+  ++stats.branches;
+  if (bound.done(maximum_clique.size())) return;
+
+  // Qualified calls, so that the compiler can inline them
+  cand_man.Cand_Man::init(&mygraph, bound(maximum_clique.size()) + 1,
+                                                       &current_clique);
+  update(maximum_clique, current_clique);
+  while ((cand = cand_man.Cand_Man::next(&mygraph,
+              bound(maximum_clique.size()) + 1, &current_clique)) != -1)
+  {
+    if (depth + 2 > (int)sets.size()) reserve(depth + 2);
+    Graph::Vertices &tmpgraph = *sets[depth+1];
+    Graph::Vertices &tmpclique = *cliques[depth+1];
+
+    if (best_to_worst)
+    {
+      // Assume cand is in clique
+      tmpclique.assign(current_clique);
+      tmpclique.insert(cand);
+      update(maximum_clique, tmpclique);
+      tmpgraph.assign(mygraph);
+      tmpgraph.remove_nnbrs(cand);
+      tmpgraph.remove(cand);
+      expand(depth + 1, maximum_clique);
+
+      // Assume cand is not in clique
+      mygraph.remove(cand);
+
+      // Every clique with a candidate cand dominates has a counterpart of
+      // the same size with cand, and those were just searched
+      if (dominance) stats.dominated += mygraph.remove_dominated(cand);
+    }
+
+    else
+    {
+      // Assume cand is not in clique
+      update(maximum_clique, current_clique);
+      mygraph.remove(cand);
+      tmpgraph.assign(mygraph);
+      tmpclique.assign(current_clique);
+      expand(depth + 1, maximum_clique);
+
+      // Assume cand is in clique
+      current_clique.insert(cand);
+      update(maximum_clique, current_clique);
+      mygraph.remove_nnbrs(cand);
+    }
+
+    // Simple search tree pruning
+    if (mygraph.size() + current_clique.size() <=
+                                   bound(maximum_clique.size())) break;
+    if (bound.done(maximum_clique.size())) break;
+  }
+
+  update(maximum_clique, current_clique);
+}
+
+template <class Cand_Man, bool best_to_worst, class Bound>
+void Static_Brancher<Cand_Man, best_to_worst, Bound>::reserve(int levels)
+{
+  while ((int)sets.size() < levels)
+  {
+    sets.push_back(new Graph::Vertices(*g));
+    cliques.push_back(new Graph::Vertices(*g));
+    cand_mans.push_back(new Cand_Man);
+  }
+}
+
+template <class Cand_Man, bool best_to_worst, class Bound>
+void Static_Brancher<Cand_Man, best_to_worst, Bound>::release()
+{
+  int i;
+
+  for (i=0; i<(int)sets.size(); ++i)
+  {
+    delete sets[i];
+    delete cliques[i];
+    delete cand_mans[i];
+  }
+  sets.clear();
+  cliques.clear();
+  cand_mans.clear();
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include <thread>
+#include <atomic>
+#include "Truss_Preprocessor.h"
+
+// Shared state of one round of support counting
+struct Truss_Round
+{
+  const Graph *g;
+  const vector<char> *dirty;   // Nodes that lost an edge last round
+  int min_support;
+  atomic<int> next_row;
+};
+
+// Collect the edges (u, w), u < w, with too little support.  Only edges
+// with a dirty endpoint are counted:  removing edge (u, v) lowers only the
+// support of edges at u or v.
+static void count_support(Truss_Round *r, vector<pair<int, int> > *weak)
+{
+  const Graph &g = *r->g;
+  const vector<char> &dirty = *r->dirty;
+  const unsigned long *row;
+  unsigned long w;
+  int i, b, u, v;
+
+  while ((u = r->next_row++) < g.max_size())
+  {
+    row = g.row(u);
+    for (i=u / NUM_ULBITS; i<g.row_words(); i++)
+    {
+      for (w = row[i]; w != 0; w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+      {
+        b = __builtin_clzl(w);
+        v = i * NUM_ULBITS + b;
+        if (v <= u || (!dirty[u] && !dirty[v])) continue;
+        if (g.cmn_nbrs(u, v) < r->min_support) weak->push_back(make_pair(u, v));
+      }
+    }
+  }
+}
+
+long Truss_Preprocessor(Graph &mygraph, int min_clique_size, int num_threads)
+{
+  int i, t, n;
+  long num_removed = 0;
+  vector<char> dirty(mygraph.max_size(), 1);
+  vector<vector<pair<int, int> > > weak;
+  vector<thread> workers;
+  Truss_Round r;
+
+  if (min_clique_size < 3) return 0;
+  r.g = &mygraph;
+  r.dirty = &dirty;
+  r.min_support = min_clique_size - 2;
+
+  while (1)
+  {
+    // Supports only fall as edges are removed, so every edge found weak in
+    // this round can be removed at once
+    if (mygraph.esize() < TRUSS_PAR_MIN_EDGES) num_threads = 1;
+    weak.assign(max(1, num_threads), vector<pair<int, int> >());
+    r.next_row = 0;
+    workers.clear();
+    for (t=1; t<(int)weak.size(); ++t)
+                       workers.push_back(thread(count_support, &r, &weak[t]));
+    count_support(&r, &weak[0]);
+    for (t=0; t<(int)workers.size(); ++t) workers[t].join();
+
+    fill(dirty.begin(), dirty.end(), 0);
+    n = 0;
+    for (t=0; t<(int)weak.size(); ++t)
+    {
+      for (i=0; i<(int)weak[t].size(); ++i)
+      {
+        mygraph.disconnect(weak[t][i].first, weak[t][i].second);
+        dirty[weak[t][i].first] = dirty[weak[t][i].second] = 1;
+        ++n;
+      }
+    }
+    if (n == 0) break;
+    num_removed += n;
+  }
+
+  // A node without neighbors is in no clique of 2 or more nodes
+  if (num_removed > 0)
+  {
+    for (i=0; i<mygraph.max_size(); ++i)
+                                if (mygraph.degree(i) == 0) mygraph.remove(i);
+  }
+
+  return num_removed;
+}
@@ -0,0 +1,25 @@
+// Edge preprocessing by truss decomposition.  Every edge of a clique of k
+// nodes lies in k - 2 triangles of the clique, so an edge whose endpoints
+// have fewer than k - 2 common neighbors (its support) is in no such clique
+// and can be disconnected.  Removing an edge lowers the support of the edges
+// of its triangles, so pruning repeats until every edge left has enough
+// support (the graph is then its k-truss).  The vertex preprocessors see
+// fewer edges afterwards, and nodes left without neighbors are removed.
+
+#ifndef _TRUSS_PREPROCESSOR_H
+#define _TRUSS_PREPROCESSOR_H 1
+
+#include "Graph.h"
+using namespace std;
+
+// Graphs with fewer edges than this are pruned with one thread
+#define TRUSS_PAR_MIN_EDGES 20000
+
+// Disconnect every edge of mygraph in fewer than min_clique_size - 2
+// triangles, then remove nodes that lost all their edges.  Supports are
+// computed in parallel over rows with up to num_threads threads.  Returns
+// the number of edges removed.
+long Truss_Preprocessor(Graph &mygraph, int min_clique_size,
+                                                     int num_threads = 1);
+
+#endif
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstring>
+#include "Twin_Reduction.h"
+
+// Orders nodes by row hash, then by node number
+struct Hash_Order
+{
+  const vector<unsigned long> &h;
+  Hash_Order(const vector<unsigned long> &hv) :h(hv) {}
+  bool operator() (int a, int b) const
+                               {return h[a] < h[b] || (h[a] == h[b] && a < b);}
+};
+
+void false_twins(const Graph &g, vector<vector<int> > &classes)
+{
+  int i, j, k, n, num_words = g.row_words();
+  unsigned long x;
+  size_t row_bytes = num_words * sizeof(unsigned long);
+  const unsigned long *r;
+  vector<unsigned long> h(g.max_size(), 0);
+  vector<int> nodes, reps;
+
+  classes.clear();
+
+  // Hash the rows of nodes with neighbors.  Nodes without neighbors are in
+  // no clique of two nodes, which the other preprocessors handle.
+  for (n=0; n<g.max_size(); ++n)
+  {
+    if (g.degree(n) == 0) continue;
+    r = g.row(n);
+    x = 14695981039346656037UL;
+    for (i=0; i<num_words; ++i)
+    {
+      x ^= r[i];
+      x *= 1099511628211UL;
+      x ^= x >> 29;
+    }
+    h[n] = x;
+    nodes.push_back(n);
+  }
+  sort(nodes.begin(), nodes.end(), Hash_Order(h));
+
+  // Split each run of equal hashes into classes of equal rows
+  for (i=0; i<(int)nodes.size(); i=j)
+  {
+    for (j=i+1; j<(int)nodes.size() && h[nodes[j]] == h[nodes[i]]; ++j);
+    if (j - i < 2) continue;
+
+    reps.clear();
+    for (k=i; k<j; ++k)
+    {
+      for (n=0; n<(int)reps.size(); ++n)
+      {
+        if (!memcmp(g.row(nodes[k]), g.row(classes[reps[n]][0]), row_bytes))
+                                                                        break;
+      }
+      if (n == (int)reps.size())
+      {
+        reps.push_back(classes.size());
+        classes.push_back(vector<int>());
+      }
+      classes[reps[n]].push_back(nodes[k]);
+    }
+  }
+
+  // Drop singletons
+  for (i=j=0; i<(int)classes.size(); ++i)
+                        if (classes[i].size() > 1) classes[j++].swap(classes[i]);
+  classes.resize(j);
+}
+
+int Twin_Preprocessor(Graph &mygraph)
+{
+  int i, j, num_removed = 0;
+  vector<vector<int> > classes;
+
+  false_twins(mygraph, classes);
+  for (i=0; i<(int)classes.size(); ++i)
+  {
+    for (j=1; j<(int)classes[i].size(); ++j) mygraph.remove(classes[i][j]);
+    num_removed += classes[i].size() - 1;
+  }
+
+  return num_removed;
+}
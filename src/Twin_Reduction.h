@@ -0,0 +1,28 @@
+// Twin reduction.  Nodes u and v are false twins if they have the same
+// neighbors (and so are not adjacent).  A clique holds at most one node of
+// a class of false twins, and any one of them can replace another, so all
+// but one node of each class can be removed without changing the maximum
+// clique size.  Classes are found by hashing the rows of the adjacency
+// matrix and comparing rows only within equal hashes.
+//
+// (True twins, adjacent nodes with the same closed neighborhoods, are in
+// every maximal clique together.  The maximal clique enumerator contracts
+// them (see bk.c); the branching engines count nodes, not weights, so they
+// cannot.)
+
+#ifndef _TWIN_REDUCTION_H
+#define _TWIN_REDUCTION_H 1
+
+#include <vector>
+#include "Graph.h"
+using namespace std;
+
+// Classes of false twins among the nodes of g, each class with at least two
+// nodes and listed in increasing node order
+void false_twins(const Graph &g, vector<vector<int> > &classes);
+
+// Remove all but the first node of every class of false twins.  Returns the
+// number of nodes removed.
+int Twin_Preprocessor(Graph &mygraph);
+
+#endif
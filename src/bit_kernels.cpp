@@ -0,0 +1,424 @@
+#include <cstdlib>
+#include <cstring>
+#include "bit_counters.h"
+#include "bit_kernels.h"
+
+// Runtime-dispatched SIMD paths are only built for x86 with a GCC-compatible
+// compiler, which provides per-function target attributes and
+// __builtin_cpu_supports.  Everything else uses the scalar kernels.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BIT_KERNELS_X86 1
+#include <immintrin.h>
+#if (defined(__clang__) && __clang_major__ >= 8) || \
+    (!defined(__clang__) && __GNUC__ >= 8)
+#define BIT_KERNELS_AVX512 1
+#endif
+#endif
+
+// Number of unsigned longs in one SIMD register
+#define ULS_PER_M256 ((int)(32 / sizeof(unsigned long)))
+#define ULS_PER_M512 ((int)(64 / sizeof(unsigned long)))
+
+// Scalar kernels - the original bitarray loops
+static int count_scalar(const unsigned long *a, int n)
+{
+  return count_ones_fast(const_cast<unsigned long *>(a), n);
+}
+
+static void and_scalar(unsigned long *dst, const unsigned long *src, int n)
+{
+  int i;
+  for (i=0; i<n; i++) dst[i] &= src[i];
+}
+
+static void or_scalar(unsigned long *dst, const unsigned long *src, int n)
+{
+  int i;
+  for (i=0; i<n; i++) dst[i] |= src[i];
+}
+
+static void xor_scalar(unsigned long *dst, const unsigned long *src, int n)
+{
+  int i;
+  for (i=0; i<n; i++) dst[i] ^= src[i];
+}
+
+static void not_scalar(unsigned long *dst, int n)
+{
+  int i;
+  for (i=0; i<n; i++) dst[i] = ~dst[i];
+}
+
+static void andnot_scalar(unsigned long *dst, const unsigned long *src, int n)
+{
+  int i;
+  for (i=0; i<n; i++) dst[i] &= ~src[i];
+}
+
+// The scalar fused counts combine words into a small stack buffer and count
+// the buffer with the lookup-table counter, so no heap temporaries are made.
+#define SCALAR_BUF_ULS 32
+
+#define SCALAR_FUSED_COUNT(fname, params, expr) \
+static int fname params \
+{ \
+  int i, j, len; \
+  int bitcount = 0; \
+  unsigned long buf[SCALAR_BUF_ULS]; \
+  for (i=0; i<n; i += SCALAR_BUF_ULS) \
+  { \
+    len = (n - i < SCALAR_BUF_ULS) ? n - i : SCALAR_BUF_ULS; \
+    for (j=0; j<len; j++) buf[j] = expr; \
+    bitcount += count_ones_fast(buf, len); \
+  } \
+  return bitcount; \
+}
+
+SCALAR_FUSED_COUNT(and_count_scalar,
+    (const unsigned long *a, const unsigned long *b, int n),
+    a[i+j] & b[i+j])
+SCALAR_FUSED_COUNT(and3_count_scalar,
+    (const unsigned long *a, const unsigned long *b, const unsigned long *c,
+                                                                       int n),
+    a[i+j] & b[i+j] & c[i+j])
+SCALAR_FUSED_COUNT(andnot_count_scalar,
+    (const unsigned long *a, const unsigned long *b, int n),
+    a[i+j] & ~b[i+j])
+
+#ifdef BIT_KERNELS_X86
+
+// POPCNT kernels - hardware population count, one word at a time
+__attribute__((target("popcnt")))
+static int count_popcnt(const unsigned long *a, int n)
+{
+  int i;
+  int bitcount = 0;
+  for (i=0; i<n; i++) bitcount += __builtin_popcountl(a[i]);
+  return bitcount;
+}
+
+__attribute__((target("popcnt")))
+static int and_count_popcnt(const unsigned long *a, const unsigned long *b,
+                                                                        int n)
+{
+  int i;
+  int bitcount = 0;
+  for (i=0; i<n; i++) bitcount += __builtin_popcountl(a[i] & b[i]);
+  return bitcount;
+}
+
+__attribute__((target("popcnt")))
+static int and3_count_popcnt(const unsigned long *a, const unsigned long *b,
+                             const unsigned long *c, int n)
+{
+  int i;
+  int bitcount = 0;
+  for (i=0; i<n; i++) bitcount += __builtin_popcountl(a[i] & b[i] & c[i]);
+  return bitcount;
+}
+
+__attribute__((target("popcnt")))
+static int andnot_count_popcnt(const unsigned long *a, const unsigned long *b,
+                                                                        int n)
+{
+  int i;
+  int bitcount = 0;
+  for (i=0; i<n; i++) bitcount += __builtin_popcountl(a[i] & ~b[i]);
+  return bitcount;
+}
+
+// AVX2 kernels.  Counting uses the nibble lookup method (vpshufb) with
+// byte sums accumulated through vpsadbw.
+// Per-64-bit-lane population counts of v
+__attribute__((target("avx2")))
+static inline __m256i popcount_lanes_avx2(__m256i v)
+{
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3,
+                                          1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, low_mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                _mm256_shuffle_epi8(lookup, hi));
+  return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static inline int sum_lanes_avx2(__m256i acc)
+{
+  unsigned long long sums[4];
+  _mm256_storeu_si256((__m256i *)sums, acc);
+  return (int)(sums[0] + sums[1] + sums[2] + sums[3]);
+}
+
+// Counting kernels differ only in how each block is formed from the inputs:
+// vexpr builds a 256-bit block at word i and sexpr a single tail word.
+#define LOAD256(p) _mm256_loadu_si256((const __m256i *)((p) + i))
+
+#define AVX2_COUNT(fname, params, vexpr, sexpr) \
+__attribute__((target("avx2,popcnt"))) \
+static int fname params \
+{ \
+  int i = 0; \
+  int bitcount; \
+  __m256i acc = _mm256_setzero_si256(); \
+  for (; i + ULS_PER_M256 <= n; i += ULS_PER_M256) \
+    acc = _mm256_add_epi64(acc, popcount_lanes_avx2(vexpr)); \
+  bitcount = sum_lanes_avx2(acc); \
+  for (; i<n; i++) bitcount += __builtin_popcountl(sexpr); \
+  return bitcount; \
+}
+
+AVX2_COUNT(count_avx2, (const unsigned long *a, int n),
+    LOAD256(a),
+    a[i])
+AVX2_COUNT(and_count_avx2,
+    (const unsigned long *a, const unsigned long *b, int n),
+    _mm256_and_si256(LOAD256(a), LOAD256(b)),
+    a[i] & b[i])
+AVX2_COUNT(and3_count_avx2,
+    (const unsigned long *a, const unsigned long *b, const unsigned long *c,
+                                                                       int n),
+    _mm256_and_si256(_mm256_and_si256(LOAD256(a), LOAD256(b)), LOAD256(c)),
+    a[i] & b[i] & c[i])
+AVX2_COUNT(andnot_count_avx2,
+    (const unsigned long *a, const unsigned long *b, int n),
+    _mm256_andnot_si256(LOAD256(b), LOAD256(a)),
+    a[i] & ~b[i])
+
+#define AVX2_BINOP(fname, intrinsic, op) \
+__attribute__((target("avx2"))) \
+static void fname(unsigned long *dst, const unsigned long *src, int n) \
+{ \
+  int i = 0; \
+  for (; i + ULS_PER_M256 <= n; i += ULS_PER_M256) \
+  { \
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i)); \
+    __m256i s = _mm256_loadu_si256((const __m256i *)(src + i)); \
+    _mm256_storeu_si256((__m256i *)(dst + i), intrinsic(d, s)); \
+  } \
+  for (; i<n; i++) dst[i] op src[i]; \
+}
+
+AVX2_BINOP(and_avx2, _mm256_and_si256, &=)
+AVX2_BINOP(or_avx2, _mm256_or_si256, |=)
+AVX2_BINOP(xor_avx2, _mm256_xor_si256, ^=)
+
+__attribute__((target("avx2")))
+static void andnot_avx2(unsigned long *dst, const unsigned long *src, int n)
+{
+  int i = 0;
+  for (; i + ULS_PER_M256 <= n; i += ULS_PER_M256)
+  {
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_andnot_si256(s, d));
+  }
+  for (; i<n; i++) dst[i] &= ~src[i];
+}
+
+__attribute__((target("avx2")))
+static void not_avx2(unsigned long *dst, int n)
+{
+  int i = 0;
+  const __m256i ones = _mm256_set1_epi32(-1);
+  for (; i + ULS_PER_M256 <= n; i += ULS_PER_M256)
+  {
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(d, ones));
+  }
+  for (; i<n; i++) dst[i] = ~dst[i];
+}
+
+#ifdef BIT_KERNELS_AVX512
+
+// AVX-512 kernels.  Counting needs the VPOPCNTDQ extension; the logical
+// operations only need AVX-512F.
+#define LOAD512(p) _mm512_loadu_si512((const void *)((p) + i))
+
+// a & ~b.  Spelled with and/xor because _mm512_andnot_si512 trips a
+// spurious -Wmaybe-uninitialized in some GCC headers; the compiler still
+// emits a single vpandnq/vpternlogq.
+#define ANDNOT512(a, b) \
+  _mm512_and_si512((a), _mm512_xor_si512((b), _mm512_set1_epi32(-1)))
+
+#define AVX512_COUNT(fname, params, vexpr, sexpr) \
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt"))) \
+static int fname params \
+{ \
+  int i = 0; \
+  int j; \
+  int bitcount = 0; \
+  unsigned long long sums[8]; \
+  __m512i acc = _mm512_setzero_si512(); \
+  for (; i + ULS_PER_M512 <= n; i += ULS_PER_M512) \
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(vexpr)); \
+  _mm512_storeu_si512((void *)sums, acc); \
+  for (j=0; j<8; j++) bitcount += (int)sums[j]; \
+  for (; i<n; i++) bitcount += __builtin_popcountl(sexpr); \
+  return bitcount; \
+}
+
+AVX512_COUNT(count_avx512, (const unsigned long *a, int n),
+    LOAD512(a),
+    a[i])
+AVX512_COUNT(and_count_avx512,
+    (const unsigned long *a, const unsigned long *b, int n),
+    _mm512_and_si512(LOAD512(a), LOAD512(b)),
+    a[i] & b[i])
+AVX512_COUNT(and3_count_avx512,
+    (const unsigned long *a, const unsigned long *b, const unsigned long *c,
+                                                                       int n),
+    _mm512_and_si512(_mm512_and_si512(LOAD512(a), LOAD512(b)), LOAD512(c)),
+    a[i] & b[i] & c[i])
+AVX512_COUNT(andnot_count_avx512,
+    (const unsigned long *a, const unsigned long *b, int n),
+    ANDNOT512(LOAD512(a), LOAD512(b)),
+    a[i] & ~b[i])
+
+#define AVX512_BINOP(fname, intrinsic, op) \
+__attribute__((target("avx512f"))) \
+static void fname(unsigned long *dst, const unsigned long *src, int n) \
+{ \
+  int i = 0; \
+  for (; i + ULS_PER_M512 <= n; i += ULS_PER_M512) \
+  { \
+    __m512i d = _mm512_loadu_si512((const void *)(dst + i)); \
+    __m512i s = _mm512_loadu_si512((const void *)(src + i)); \
+    _mm512_storeu_si512((void *)(dst + i), intrinsic(d, s)); \
+  } \
+  for (; i<n; i++) dst[i] op src[i]; \
+}
+
+AVX512_BINOP(and_avx512, _mm512_and_si512, &=)
+AVX512_BINOP(or_avx512, _mm512_or_si512, |=)
+AVX512_BINOP(xor_avx512, _mm512_xor_si512, ^=)
+
+__attribute__((target("avx512f")))
+static void andnot_avx512(unsigned long *dst, const unsigned long *src, int n)
+{
+  int i = 0;
+  for (; i + ULS_PER_M512 <= n; i += ULS_PER_M512)
+  {
+    __m512i d = _mm512_loadu_si512((const void *)(dst + i));
+    __m512i s = _mm512_loadu_si512((const void *)(src + i));
+    _mm512_storeu_si512((void *)(dst + i), ANDNOT512(d, s));
+  }
+  for (; i<n; i++) dst[i] &= ~src[i];
+}
+
+__attribute__((target("avx512f")))
+static void not_avx512(unsigned long *dst, int n)
+{
+  int i = 0;
+  const __m512i ones = _mm512_set1_epi32(-1);
+  for (; i + ULS_PER_M512 <= n; i += ULS_PER_M512)
+  {
+    __m512i d = _mm512_loadu_si512((const void *)(dst + i));
+    _mm512_storeu_si512((void *)(dst + i), _mm512_xor_si512(d, ones));
+  }
+  for (; i<n; i++) dst[i] = ~dst[i];
+}
+
+#endif  // BIT_KERNELS_AVX512
+#endif  // BIT_KERNELS_X86
+
+// Start with the scalar kernels (constant-initialized, so safe to use from
+// any static constructor) and upgrade below once the CPU has been probed.
+bit_kernel_table bit_kernels = {"scalar", count_scalar, and_scalar, or_scalar,
+                                xor_scalar, not_scalar, and_count_scalar,
+                                and3_count_scalar, andnot_count_scalar,
+                                andnot_scalar};
+
+// Kernel levels, in increasing order of preference
+enum {KERNEL_SCALAR, KERNEL_POPCNT, KERNEL_AVX2, KERNEL_AVX512};
+
+static int requested_kernel_level()
+{
+  const char *req = getenv("CLIQUER_BIT_KERNEL");
+  if (req == 0) return KERNEL_AVX512;
+  if (strcmp(req, "scalar") == 0) return KERNEL_SCALAR;
+  if (strcmp(req, "popcnt") == 0) return KERNEL_POPCNT;
+  if (strcmp(req, "avx2") == 0) return KERNEL_AVX2;
+  return KERNEL_AVX512;
+}
+
+static void select_bit_kernels()
+{
+  int max_level = requested_kernel_level();
+
+#ifdef BIT_KERNELS_X86
+  __builtin_cpu_init();
+
+#ifdef BIT_KERNELS_AVX512
+  if (max_level >= KERNEL_AVX512 && __builtin_cpu_supports("avx512f"))
+  {
+    bit_kernels.name = "avx512";
+    bit_kernels.and_words = and_avx512;
+    bit_kernels.or_words = or_avx512;
+    bit_kernels.xor_words = xor_avx512;
+    bit_kernels.not_words = not_avx512;
+    bit_kernels.andnot_words = andnot_avx512;
+    if (__builtin_cpu_supports("avx512vpopcntdq"))
+    {
+      bit_kernels.count = count_avx512;
+      bit_kernels.and_count = and_count_avx512;
+      bit_kernels.and3_count = and3_count_avx512;
+      bit_kernels.andnot_count = andnot_count_avx512;
+    }
+    else if (__builtin_cpu_supports("avx2") &&
+             __builtin_cpu_supports("popcnt"))
+    {
+      bit_kernels.count = count_avx2;
+      bit_kernels.and_count = and_count_avx2;
+      bit_kernels.and3_count = and3_count_avx2;
+      bit_kernels.andnot_count = andnot_count_avx2;
+    }
+    else if (__builtin_cpu_supports("popcnt"))
+    {
+      bit_kernels.count = count_popcnt;
+      bit_kernels.and_count = and_count_popcnt;
+      bit_kernels.and3_count = and3_count_popcnt;
+      bit_kernels.andnot_count = andnot_count_popcnt;
+    }
+    return;
+  }
+#endif
+
+  if (max_level >= KERNEL_AVX2 && __builtin_cpu_supports("avx2") &&
+                                  __builtin_cpu_supports("popcnt"))
+  {
+    bit_kernels.name = "avx2";
+    bit_kernels.count = count_avx2;
+    bit_kernels.and_words = and_avx2;
+    bit_kernels.or_words = or_avx2;
+    bit_kernels.xor_words = xor_avx2;
+    bit_kernels.not_words = not_avx2;
+    bit_kernels.and_count = and_count_avx2;
+    bit_kernels.and3_count = and3_count_avx2;
+    bit_kernels.andnot_count = andnot_count_avx2;
+    bit_kernels.andnot_words = andnot_avx2;
+    return;
+  }
+
+  if (max_level >= KERNEL_POPCNT && __builtin_cpu_supports("popcnt"))
+  {
+    bit_kernels.name = "popcnt";
+    bit_kernels.count = count_popcnt;
+    bit_kernels.and_count = and_count_popcnt;
+    bit_kernels.and3_count = and3_count_popcnt;
+    bit_kernels.andnot_count = andnot_count_popcnt;
+    return;
+  }
+#endif
+
+  (void)max_level;
+}
+
+static struct bit_kernel_selector
+{
+  bit_kernel_selector() {select_bit_kernels();}
+} bit_kernel_selector_instance;
@@ -0,0 +1,48 @@
+// Word-array kernels for the bitarray library.
+// Every bulk operation on a bitarray (counting, and/or/xor, complement) is
+// routed through a small table of function pointers.  The table starts out
+// pointing at portable scalar code and is upgraded once, at load time, to
+// the fastest implementation the running CPU supports (POPCNT, AVX2 or
+// AVX-512).  All implementations produce bit-for-bit identical results.
+//
+// The environment variable CLIQUER_BIT_KERNEL ("scalar", "popcnt", "avx2"
+// or "avx512") caps the selection, which is handy for benchmarking and for
+// checking that the vectorized paths agree with the scalar ones.
+
+#ifndef _BIT_KERNELS_H
+#define _BIT_KERNELS_H 1
+
+struct bit_kernel_table
+{
+  const char *name;
+
+  // Number of one bits in a[0..n)
+  int (*count)(const unsigned long *a, int n);
+
+  // In-place dst[i] op= src[i] for i in [0..n)
+  void (*and_words)(unsigned long *dst, const unsigned long *src, int n);
+  void (*or_words)(unsigned long *dst, const unsigned long *src, int n);
+  void (*xor_words)(unsigned long *dst, const unsigned long *src, int n);
+
+  // In-place dst[i] = ~dst[i] for i in [0..n)
+  void (*not_words)(unsigned long *dst, int n);
+
+  // Fused operations, done in one pass without a temporary array
+  // and_count:     number of one bits in a & b
+  // and3_count:    number of one bits in a & b & c
+  // andnot_count:  number of one bits in a & ~b
+  // andnot_words:  in-place dst[i] &= ~src[i]
+  int (*and_count)(const unsigned long *a, const unsigned long *b, int n);
+  int (*and3_count)(const unsigned long *a, const unsigned long *b,
+                    const unsigned long *c, int n);
+  int (*andnot_count)(const unsigned long *a, const unsigned long *b, int n);
+  void (*andnot_words)(unsigned long *dst, const unsigned long *src, int n);
+};
+
+// The active kernels.  Never null, even during static initialization.
+extern bit_kernel_table bit_kernels;
+
+// Name of the active kernel set ("scalar", "popcnt", "avx2" or "avx512")
+inline const char *bit_kernel_name() {return bit_kernels.name;}
+
+#endif
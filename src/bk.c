@@ -19,6 +19,11 @@ int NUM_CLIQUES;
 int CLIQUES_SZ;
 vid_t ** CLIQUES;
 
+/* True twin classes (see contract_twins):  WEIGHT[u] is the size of the
+   class of representative u, and TWIN_NEXT links its other members */
+int *WEIGHT;
+vid_t *TWIN_NEXT;
+
 /* ------------------------------------------------------------- *
  * Function: free_cliques()                                      *
  * ------------------------------------------------------------- */
@@ -30,6 +35,124 @@ void free_cliques() {
   free(CLIQUES);
 }
 
+/* ------------------------------------------------------------- *
+ * Function: free_twins()                                        *
+ * ------------------------------------------------------------- */
+void free_twins() {
+  free(WEIGHT);
+  free(TWIN_NEXT);
+  WEIGHT = NULL;
+  TWIN_NEXT = NULL;
+}
+
+/* ------------------------------------------------------------- *
+ * Function: closed_row_hash()                                   *
+ *   Hash of the neighbors of u together with u                  *
+ * ------------------------------------------------------------- */
+static u64 closed_row_hash(Graph *G, vid_t u)
+{
+  unsigned int *r = neighbors(G, u);
+  unsigned int w;
+  int i, nw = G->_num_bytes / sizeof(unsigned int);
+  u64 h = 14695981039346656037UL;
+
+  for (i = 0; i < nw; i++) {
+    w = r[i];
+    if (i == (u >> RSV)) w |= 1U << (u & XBM);
+    h ^= w;
+    h *= 1099511628211UL;
+  }
+  return h;
+}
+
+/* ------------------------------------------------------------- *
+ * Function: true_twins()                                        *
+ *   1 if u and v are adjacent and have the same neighbors       *
+ *   besides each other                                          *
+ * ------------------------------------------------------------- */
+static int true_twins(Graph *G, vid_t u, vid_t v)
+{
+  unsigned int *ru = neighbors(G, u), *rv = neighbors(G, v);
+  unsigned int a, b;
+  int i, nw = G->_num_bytes / sizeof(unsigned int);
+
+  if (!edge_exists(G, u, v)) return 0;
+  for (i = 0; i < nw; i++) {
+    a = ru[i];
+    b = rv[i];
+    if (i == (u >> RSV)) { a |= 1U << (u & XBM); b |= 1U << (u & XBM); }
+    if (i == (v >> RSV)) { a |= 1U << (v & XBM); b |= 1U << (v & XBM); }
+    if (a != b) return 0;
+  }
+  return 1;
+}
+
+static u64 *twin_hash;
+
+static int hash_cmp(const void *a, const void *b)
+{
+  vid_t u = *(const vid_t *)a, v = *(const vid_t *)b;
+  if (twin_hash[u] != twin_hash[v]) return twin_hash[u] < twin_hash[v] ? -1 : 1;
+  return (int)u - (int)v;
+}
+
+/* ------------------------------------------------------------- *
+ * Function: contract_twins()                                    *
+ *   True twins are in the same maximal cliques, so the cliques  *
+ *   are enumerated over one representative per class and each   *
+ *   representative is expanded to its class on output.  Fills   *
+ *   reps with the representatives in increasing order and       *
+ *   returns their number, or -1 if out of memory.               *
+ * ------------------------------------------------------------- */
+int contract_twins(Graph *G, vid_t *reps)
+{
+  unsigned int n = num_vertices(G);
+  vid_t order[n];
+  vid_t u;
+  int i, j, k, m, nreps = 0;
+
+  WEIGHT = malloc(sizeof(int) * n);
+  TWIN_NEXT = malloc(sizeof(vid_t) * n);
+  twin_hash = malloc(sizeof(u64) * n);
+  if (WEIGHT == NULL || TWIN_NEXT == NULL || twin_hash == NULL) {
+    free(twin_hash);
+    free_twins();
+    error("malloc: Memory exhausted, quitting");
+    return -1;
+  }
+
+  for (i = 0; i < n; i++) {
+    order[i] = i;
+    WEIGHT[i] = 1;
+    TWIN_NEXT[i] = (vid_t)-1;
+    twin_hash[i] = closed_row_hash(G, i);
+  }
+  qsort(order, n, sizeof(vid_t), hash_cmp);
+
+  /* Within a run of equal hashes, attach each node to the first
+     earlier node it is a twin of; weight 0 marks attached nodes */
+  for (i = 0; i < n; i = j) {
+    for (j = i+1; j < n && twin_hash[order[j]] == twin_hash[order[i]]; j++);
+    for (k = i+1; k < j; k++) {
+      u = order[k];
+      for (m = i; m < k; m++) {
+        if (WEIGHT[order[m]] > 0 && true_twins(G, order[m], u)) break;
+      }
+      if (m == k) continue;
+      WEIGHT[u] = 0;
+      WEIGHT[order[m]]++;
+      TWIN_NEXT[u] = TWIN_NEXT[order[m]];
+      TWIN_NEXT[order[m]] = u;
+    }
+  }
+  free(twin_hash);
+
+  for (i = 0; i < n; i++) {
+    if (WEIGHT[i] > 0) reps[nreps++] = i;
+  }
+  return nreps;
+}
+
 /* ------------------------------------------------------------- *
  * Function: extract_cliques()                                     *
  * ------------------------------------------------------------- */
@@ -51,16 +174,21 @@ void extract_cliques(SEXP R_cliques, Graph *G) {
 /* ------------------------------------------------------------- *
  * Function: append_clique()                                     *
  * ------------------------------------------------------------- */
-int append_clique(Graph *G, vid_t *clique, int len)
+int append_clique(Graph *G, vid_t *clique, int len, int size)
 {
   vid_t *new_clique;
-  new_clique = malloc(sizeof(vid_t)*(len+1));
+  vid_t u;
+  int i, j;
+  new_clique = malloc(sizeof(vid_t)*(size+1));
   if (new_clique == NULL) {
 	  error("malloc: Memory exhausted, quitting");
 	  return 1;
   }
-  new_clique[0] = len;
-  memcpy(new_clique+1, clique, sizeof(vid_t)*len);
+  new_clique[0] = size;
+  /* Expand each representative to its twin class */
+  for (i = 0, j = 1; i < len; i++) {
+    for (u = clique[i]; u != (vid_t)-1; u = TWIN_NEXT[u]) new_clique[j++] = u;
+  }
   
   if (NUM_CLIQUES == CLIQUES_SZ) {
 	  vid_t **tmp = realloc(CLIQUES, sizeof(vid_t*)*CLIQUES_SZ*2);
@@ -113,9 +241,10 @@ SEXP clique_profile_out(u64 *nclique, Graph *G)
  * Function: clique_find_v2()                                    *
  *   Bron-Kerbosch version 2                                     *
  *   Recursive function to find cliques                          *
+ *   lc representatives are in clique, sz nodes once expanded    *
  * ------------------------------------------------------------- */
 int clique_find_v2(u64 *nclique, Graph *G, \
-		vid_t *clique, vid_t *old, int lc, int ne, int ce)
+		vid_t *clique, vid_t *old, int lc, int sz, int ne, int ce)
 {
   vid_t new[ce];
   int new_ne, new_ce;
@@ -165,17 +294,17 @@ int clique_find_v2(u64 *nclique, Graph *G, \
 	
 	/* Output clique or extend */
 	clique[lc] = u;
-	if (lc+1 <= UB) {
-	  if (new_ce == 0 && lc+1 >= LB) {
-	    nclique[lc+1]++;
+	if (sz+WEIGHT[u] <= UB) {
+	  if (new_ce == 0 && sz+WEIGHT[u] >= LB) {
+	    nclique[sz+WEIGHT[u]]++;
 		  if (!PROFILE) {
-		    if (append_clique(G, clique, lc+1))
+		    if (append_clique(G, clique, lc+1, sz+WEIGHT[u]))
 			  return 1;
 		  }
 		  NUM_CLIQUES++;
 	  }
 	  else if (new_ne < new_ce) {
-	    if(clique_find_v2(nclique, G, clique, new, lc+1, new_ne, new_ce)) return 1;
+	    if(clique_find_v2(nclique, G, clique, new, lc+1, sz+WEIGHT[u], new_ne, new_ce)) return 1;
 	  }
 	}
 	
@@ -16,6 +16,13 @@
 void free_cliques();
 
 
+/* ------------------------------------------------------------- *
+ * Function: contract_twins(), free_twins()                      *
+ * ------------------------------------------------------------- */
+int contract_twins(Graph *G, vid_t *reps);
+void free_twins();
+
+
 /* ------------------------------------------------------------- *
  * Function: clique_profile_out()                                *
  * ------------------------------------------------------------- */
@@ -27,7 +34,7 @@ SEXP clique_profile_out(u64 *nclique, Graph *G);
  *   Bron-Kerbosch version 2                                     *
  *   Recursive function to find cliques                          *
  * ------------------------------------------------------------- */
-int clique_find_v2(u64 *, Graph *, vid_t *, vid_t *, int, int, int);
+int clique_find_v2(u64 *, Graph *, vid_t *, vid_t *, int, int, int, int);
 
 
 /* ------------------------------------------------------------- *
@@ -43,6 +43,9 @@ extern int CLIQUES_SZ;
 extern vid_t **CLIQUES;
 char infn[100];
 
+/* Graph_Handle.cpp */
+Graph *graph_handle_maximal(SEXP handle);
+
 SEXP run_maximal_clique(Graph *G)
 {
   double utime;
@@ -51,26 +54,29 @@ SEXP run_maximal_clique(Graph *G)
   vid_t vertices[n];
   SEXP R_cliques = R_NilValue;
   u64 nclique[n+1];
-  int i;
+  int nreps;
 
   utime = get_cur_time();
   memset(nclique, 0, (n+1)*sizeof(u64));
   memset(clique, -1, n*sizeof(vid_t));
-  for (i = 0; i < n; i++) vertices[i] = i;
+  if ((nreps = contract_twins(G, vertices)) < 0) return R_NilValue;
   
   CLIQUES_SZ = n;
   if (!PROFILE) {
     CLIQUES = malloc(CLIQUES_SZ * sizeof(vid_t*));
 	  if (CLIQUES == NULL) {
+		  free_twins();
 		  error("malloc: Memory exhausted, quitting");
 		  return R_NilValue;
 	  }
   }
   
-  if (clique_find_v2(nclique, G, clique, vertices, 0, 0, n)) {
+  if (clique_find_v2(nclique, G, clique, vertices, 0, 0, 0, nreps)) {
+	  free_twins();
 	  free_cliques();
 	  return R_NilValue;
   }
+  free_twins();
   
   utime = get_cur_time() - utime;
 
@@ -96,6 +102,19 @@ SEXP R_maximal_clique(SEXP R_file, SEXP R_lowerbound, SEXP R_upperbound, SEXP R_
   PROFILE = asInteger(R_profile);
   NUM_CLIQUES = 0;
   
+  /* A graph handle from cliqueR.load keeps its graph, so it is not freed */
+  if (TYPEOF(R_file) == EXTPTRSXP) {
+    if ((G = graph_handle_maximal(R_file)) == NULL) {
+      REprintf("cliqueR graph handle is no longer valid\n");
+      return R_NilValue;
+    }
+    if (UB <= 0) UB = num_vertices(G);
+
+    SEXP ret = run_maximal_clique(G);
+    UNPROTECT(1);
+    return ret;
+  }
+
   const char *filepath = CHARPT(R_file, 0);
   if (strlen(filepath) > 99) {
 	  REprintf("Filepath: %s is too long. Max length is 99 characters\n", infn);
@@ -103,11 +122,11 @@ SEXP R_maximal_clique(SEXP R_file, SEXP R_lowerbound, SEXP R_upperbound, SEXP R_
   }
   strcpy(infn, filepath);
   
-  if ((fp = fopen(infn, "r")) == NULL) {
+  if ((fp = fopen(infn, "rb")) == NULL) {
     REprintf("Cannot open file %s\n", infn);
     return R_NilValue;
   }
-  G = graph_edgelist_in(fp);
+  G = graph_is_snapshot(fp) ? graph_snapshot_in(fp) : graph_edgelist_in(fp);
   fclose(fp);
   
   if (UB <= 0) UB = num_vertices(G);
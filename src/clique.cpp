@@ -21,18 +21,28 @@
 #include <string>
 #include "Graph.h"
 #include "Maxclique_Finder.h"
+#include "Sparse_Graph.h"
+#include "Graph_Handle.h"
+#include "Search_Stats.h"
 
 using namespace std;
 using namespace Rcpp;
 
-Graph::Vertices *find_mc(Graph *g);
+static StringVector sparse_maximum_clique(const Sparse_Graph &sg)
+{
+  int i;
+  vector<char> alive(sg.size(), 1);
+  vector<int> clique;
+  StringVector vertices;
 
-// [[Rcpp::export]]
-StringVector maximum_clique(std::string filename)
+  find_mc(sg, alive, clique);
+  for (i=0; i<(int)clique.size(); ++i) vertices.push_back(sg.label(clique[i]));
+  return vertices;
+}
+
+// Note:  The search alters g
+static StringVector dense_maximum_clique(Graph *g)
 {
-  
-  string graph_file(filename.c_str());
-  Graph *g = new Graph(graph_file);
   g->sort_by_degree_asc();
 
   // Find maximum clique and return it
@@ -43,3 +53,75 @@ StringVector maximum_clique(std::string filename)
   return vertices;
 }
 
+// [[Rcpp::export]]
+StringVector maximum_clique(std::string filename)
+{
+  
+  string graph_file(filename.c_str());
+
+  // Very large, sparse graphs never get a full adjacency matrix
+  int header_nodes;
+  long header_edges;
+  read_graph_header(graph_file, header_nodes, header_edges);
+  if (use_sparse_backend(header_nodes, header_edges))
+  {
+    Sparse_Graph sg(graph_file);
+    return sparse_maximum_clique(sg);
+  }
+
+  Graph *g = new Graph(graph_file);
+  StringVector vertices = dense_maximum_clique(g);
+  delete g;
+
+  return vertices;
+}
+
+// Same as maximum_clique for a graph loaded with cliqueR.load.  The result
+// is cached on the handle.
+// [[Rcpp::export]]
+StringVector handle_maximum_clique(SEXP handle)
+{
+  Graph_Handle *h = graph_handle(handle);
+
+  if (!h->have_max_clique)
+  {
+    StringVector vertices;
+    if (h->sparse_graph()) vertices = sparse_maximum_clique(*h->sparse_graph());
+    else
+    {
+      Graph g_copy(*h->graph());
+      vertices = dense_maximum_clique(&g_copy);
+    }
+    h->max_clique.assign(vertices.begin(), vertices.end());
+    h->have_max_clique = 1;
+  }
+
+  return StringVector(h->max_clique.begin(), h->max_clique.end());
+}
+
+// Set the number of threads the maximum clique search branches with (used
+// by paraclique too); 0 leaves it unchanged.  Returns the previous setting.
+// [[Rcpp::export]]
+int set_search_threads(int threads)
+{
+  if (threads < 1) return mc_threads();
+  return set_mc_threads(threads);
+}
+
+// Turn dominance pruning in the maximum clique search on (1) or off (0);
+// -1 leaves it unchanged.  Returns the previous setting.
+// [[Rcpp::export]]
+bool set_search_dominance(int dominance)
+{
+  if (dominance < 0) return mc_dominance();
+  return set_mc_dominance(dominance);
+}
+
+// Search statistics since the last call
+// [[Rcpp::export]]
+List search_stats()
+{
+  Search_Stats s = take_search_stats();
+  return List::create(Named("branches") = (double)s.branches,
+                      Named("dominated") = (double)s.dominated);
+}
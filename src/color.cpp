@@ -1,4 +1,5 @@
 #include "color.h"
+#include "bit_kernels.h"
 
 int color_subgraph(const Graph::Vertices &sg, vector<int> *node2color,
                                               vector<int> *sorted_nodes)
@@ -39,3 +40,148 @@ int color_subgraph(const Graph::Vertices &sg, vector<int> *node2color,
 
   return current_color;
 }
+
+int Bitset_Coloring::color(const Graph::Vertices &sg, vector<int> &nodes,
+                                                      vector<int> &colors)
+{
+  int i, w, b, node;
+  unsigned long *cl;
+
+  g = sg.graph();
+  nw = sg.num_words();
+  num_classes = 0;
+  nodes.clear();
+  colors.clear();
+  uncolored.assign(sg.words(), sg.words() + nw);
+  choices.resize(nw);
+
+  for (w=0; w<nw; )
+  {
+    if (uncolored[w] == 0) {++w; continue;}
+
+    // Build one color class from the uncolored nodes
+    ++num_classes;
+    if ((int)classes.size() < num_classes * nw)
+                                          classes.resize(num_classes * nw);
+    cl = &classes[(num_classes - 1) * nw];
+    for (i=0; i<nw; ++i) cl[i] = 0;
+    for (i=w; i<nw; ++i) choices[i] = uncolored[i];
+    for (i=w; i<nw; ++i)
+    {
+      while (choices[i])
+      {
+        b = __builtin_clzl(choices[i]);
+        node = i * NUM_ULBITS + b;
+        uncolored[i] &= ~(1UL << (NUM_ULBITS - 1 - b));
+        choices[i] &= ~(1UL << (NUM_ULBITS - 1 - b));
+        cl[i] |= 1UL << (NUM_ULBITS - 1 - b);
+        bit_kernels.andnot_words(&choices[i], g->row(node) + i, nw - i);
+        nodes.push_back(node);
+        colors.push_back(num_classes);
+      }
+    }
+  }
+
+  return num_classes;
+}
+
+int Bitset_Coloring::sat_prune(int k, const vector<int> &nodes,
+                               const vector<int> &colors, vector<char> &pruned)
+{
+  int i;
+  int first = lower_bound(colors.begin(), colors.end(), k) - colors.begin();
+  int left = nodes.size() - first;
+
+  // Nothing to propagate against
+  if (k <= 1) return left;
+
+  used.assign(k - 1, 0);
+  live.resize((k - 1) * nw);
+  for (i=first; i<(int)nodes.size(); ++i)
+  {
+    if (inconsistent(nodes[i], k - 1))
+    {
+      pruned[i] = 1;
+      --left;
+    }
+  }
+
+  return left;
+}
+
+// Unit propagation from node against the unused classes among the first
+// num_prefix.  On a conflict, the classes involved are marked used.
+bool Bitset_Coloring::inconsistent(int node, int num_prefix)
+{
+  int i, c, u, w, count, unit, conflict = -1;
+
+  open.clear();
+  for (c=0; c<num_prefix; ++c)
+  {
+    if (used[c]) continue;
+    open.push_back(c);
+    for (i=0; i<nw; ++i) live[c * nw + i] = classes[c * nw + i];
+    bit_kernels.and_words(&live[c * nw], g->row(node), nw);
+  }
+  lits.assign(1, node);
+  lit_class.assign(1, -1);
+
+  while (conflict == -1)
+  {
+    // Look for an emptied class, or else a class with one node left
+    unit = -1;
+    for (i=0; i<(int)open.size(); ++i)
+    {
+      count = bit_kernels.count(&live[open[i] * nw], nw);
+      if (count == 0)
+      {
+        conflict = open[i];
+        break;
+      }
+      if (count == 1 && unit == -1) unit = i;
+    }
+    if (conflict != -1) break;
+    if (unit == -1) return 0;
+
+    // Its last node is forced into the clique
+    c = open[unit];
+    open[unit] = open.back();
+    open.pop_back();
+    for (w=0; live[c * nw + w] == 0; ++w) ;
+    u = w * NUM_ULBITS + __builtin_clzl(live[c * nw + w]);
+    lits.push_back(u);
+    lit_class.push_back(c);
+    for (i=0; i<(int)open.size(); ++i)
+                   bit_kernels.and_words(&live[open[i] * nw], g->row(u), nw);
+  }
+
+  // Keep only the clauses the conflict was derived from, so that more
+  // classes are left for later nodes
+  needed.assign(lits.size(), 0);
+  mark_reasons(conflict, -1, lits.size());
+  for (i=lits.size()-1; i>0; --i)
+    if (needed[i]) mark_reasons(lit_class[i], lits[i], i);
+
+  used[conflict] = 1;
+  for (i=1; i<(int)lits.size(); ++i) if (needed[i]) used[lit_class[i]] = 1;
+  return 1;
+}
+
+// Marks, for each node of class c other than skip, the first of
+// lits[0..num_lits) that removed it
+void Bitset_Coloring::mark_reasons(int c, int skip, int num_lits)
+{
+  int i, j, x;
+  unsigned long word;
+
+  for (i=0; i<nw; ++i)
+  {
+    for (word = classes[c * nw + i]; word; word &= word - 1)
+    {
+      x = i * NUM_ULBITS + NUM_ULBITS - 1 - __builtin_ctzl(word);
+      if (x == skip) continue;
+      for (j=0; j<num_lits && g->connected(lits[j], x); ++j) ;
+      if (j < num_lits) needed[j] = 1;
+    }
+  }
+}
@@ -21,4 +21,53 @@ using namespace std;
 // Warning:  See warnings in source.
 int color_subgraph(const Graph::Vertices &sg, vector<int> *node2color = 0,
                                               vector<int> *sorted_nodes = 0);
+
+// Greedy coloring on whole words, plus MaxSAT reasoning over the coloring
+// (the infra-chromatic bound of IncMaxCLQ).
+// color() builds each class by taking the first uncolored node and removing
+// its neighbors from the class's remaining choices with one AND-NOT over
+// its row, so nodes are colored in node number order.
+// sat_prune() sees each color class as a soft clause ("some node of the
+// class is in the clique") and each non-adjacent pair as a hard clause.
+// Unit propagation from a node v against the first k-1 classes may empty a
+// class; the clauses used then form an inconsistent set, and no clique
+// takes v along with a node from each of those classes.  Each such set
+// lowers the bound of the coloring by one as long as the sets are disjoint,
+// so every node that is pruned this way can be left out of branching: the
+// first k-1 classes plus all pruned nodes still hold no clique of size k.
+class Bitset_Coloring
+{
+  const Graph *g;
+  int nw;
+  int num_classes;
+  vector<unsigned long> classes;   // Class c (from 0) is words [c*nw, c*nw+nw)
+  vector<unsigned long> uncolored;
+  vector<unsigned long> choices;
+
+  // Propagation state
+  vector<unsigned long> live;      // What is left of each class
+  vector<char> used;               // Class is in an inconsistent set already
+  vector<int> open;                // Classes neither used nor satisfied
+  vector<int> lits;                // Nodes forced into the clique, in order
+  vector<int> lit_class;           // Class that forced lits[i] (-1 for v)
+  vector<char> needed;             // lits[i] is part of the inconsistent set
+
+  public:
+  Bitset_Coloring() :g(0), nw(0), num_classes(0) {}
+
+  // Colors the nodes of sg, storing them in nodes by ascending color and
+  // their colors (from 1) in colors.  Returns the number of colors.
+  int color(const Graph::Vertices &sg, vector<int> &nodes,
+                                       vector<int> &colors);
+
+  // Sets pruned[i] for nodes of color k or more (as returned by the last
+  // call to color) that can be left out when looking for a clique of size
+  // k.  Returns the number of those nodes that remain.
+  int sat_prune(int k, const vector<int> &nodes, const vector<int> &colors,
+                                                 vector<char> &pruned);
+
+  private:
+  bool inconsistent(int node, int num_prefix);
+  void mark_reasons(int c, int skip, int num_lits);
+};
 #endif
@@ -9,6 +9,7 @@
 #include <R.h>
 
 #include "graph_maximal.h"
+#include "snapshot_format.h"
 
 // trie node
 struct TrieNode {
@@ -217,6 +218,105 @@ Graph * graph_edgelist_in(FILE *fp)
 }
 
 
+/* Returns 1 if fp is positioned at the start of a graph snapshot */
+int graph_is_snapshot(FILE *fp)
+{
+  char magic[SNAPSHOT_MAGIC_LEN];
+  long pos = ftell(fp);
+  int r = (fread(magic, 1, SNAPSHOT_MAGIC_LEN, fp) == SNAPSHOT_MAGIC_LEN &&
+           memcmp(magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) == 0);
+  fseek(fp, pos, SEEK_SET);
+  return r;
+}
+
+/* Read a section of a snapshot into freshly malloc'd memory */
+static void *snapshot_section(FILE *fp, uint64_t off, size_t bytes)
+{
+  void *p = malloc(bytes > 0 ? bytes : 1);
+  if (p == NULL) { perror("snapshot_in : malloc"); exit(-1); }
+  if (fseek(fp, (long) off, SEEK_SET) != 0 || fread(p, 1, bytes, fp) != bytes) {
+	fprintf(stderr, "Bad snapshot : truncated section\n");
+	exit(-1);
+  }
+  return p;
+}
+
+/* Read in a graph snapshot (see snapshot_format.h).  Only the labels,
+   degrees and CSR adjacency are used; no parsing or duplicate checking is
+   needed since the snapshot writer already did both. */
+Graph * graph_snapshot_in(FILE *fp)
+{
+  snapshot_header h;
+  uint64_t *label_index, *index;
+  uint32_t *degrees, *adj;
+  char *label_data;
+  unsigned int n, u;
+  uint64_t j;
+  Graph *G;
+
+  if (fread(&h, sizeof(h), 1, fp) != 1 ||
+	  memcmp(h.magic, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN) != 0) {
+	fprintf(stderr, "Bad snapshot : magic incorrect\n");
+	exit(-1);
+  }
+  if (h.version != SNAPSHOT_VERSION || h.byte_order != SNAPSHOT_BYTE_ORDER) {
+	fprintf(stderr, "Bad snapshot : unsupported version or byte order\n");
+	exit(-1);
+  }
+
+  n = (unsigned int) h.num_nodes;
+  label_index = snapshot_section(fp, h.label_index_off, (n + 1) * sizeof(uint64_t));
+  label_data = snapshot_section(fp, h.label_data_off, label_index[n]);
+  degrees = snapshot_section(fp, h.degree_off, n * sizeof(uint32_t));
+  index = snapshot_section(fp, h.csr_index_off, (n + 1) * sizeof(uint64_t));
+  adj = snapshot_section(fp, h.csr_adj_off, index[n] * sizeof(uint32_t));
+
+  G = graph_make(n);
+  for (u = 0; u < n; u++) {
+	G->_label[u] = strdup(label_data + label_index[u]);
+	if (degrees[u] > 65535) {
+	  fprintf(stderr, "Bad snapshot : degree too large for this engine\n");
+	  exit(-1);
+	}
+	G->_degree[u] = (unsigned short) degrees[u];
+	for (j = index[u]; j < index[u+1]; j++) SET_BIT(G->_neighbor[u], adj[j]);
+  }
+  G->_num_edges = (unsigned int) h.num_edges;
+
+  free(label_index);
+  free(label_data);
+  free(degrees);
+  free(index);
+  free(adj);
+  return G;
+}
+
+
+/* Build a graph from CSR adjacency: the neighbors of u are
+   adj[index[u]..index[u+1]), with no duplicates or self loops.  Labels are
+   copied.  Used for graphs that were already loaded by the C++ engines. */
+Graph * graph_from_csr(unsigned int n, const char **labels,
+                       const uint64_t *index, const uint32_t *adj)
+{
+  unsigned int u;
+  uint64_t j, m = 0;
+  Graph *G = graph_make(n);
+
+  for (u = 0; u < n; u++) {
+	G->_label[u] = strdup(labels[u]);
+	if (index[u+1] - index[u] > 65535) {
+	  fprintf(stderr, "graph_from_csr : degree too large for this engine\n");
+	  exit(-1);
+	}
+	G->_degree[u] = (unsigned short) (index[u+1] - index[u]);
+	for (j = index[u]; j < index[u+1]; j++) SET_BIT(G->_neighbor[u], adj[j]);
+	m += index[u+1] - index[u];
+  }
+  G->_num_edges = (unsigned int) (m / 2);
+  return G;
+}
+
+
 /* Write out a graph as unweighted edge-list to a file pointer */
 void UW_EdgeList_out(FILE *fp, Graph *G)
 {
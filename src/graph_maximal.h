@@ -8,6 +8,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include "utility.h"
 
 typedef unsigned short vid_t;
@@ -104,6 +105,14 @@ void graph_free(Graph *G);
 Graph *UW_EdgeList_in(FILE *fp);
 Graph *graph_edgelist_in(FILE *fp);
 
+/* Read in a graph from a binary snapshot (see snapshot_format.h) */
+int graph_is_snapshot(FILE *fp);
+Graph *graph_snapshot_in(FILE *fp);
+
+/* Build a graph from CSR adjacency (see graph_maximal.c) */
+Graph *graph_from_csr(unsigned int n, const char **labels,
+                      const uint64_t *index, const uint32_t *adj);
+
 /* Write out a graph to an unweighted edge-list format file */
 void UW_EdgeList_out(FILE *fp, Graph *G);
 
@@ -1,68 +1,192 @@
 #include "paracl.h"
+#include <cmath>
 
-void build_paracl(Graph &g, Graph::Vertices &v, double glom)
+// Bit-sliced counters, one per node of the graph:  bit k of the count of
+// node n is bit n of planes[k].  Adding a row of the adjacency matrix
+// increments the counts of all its nodes at once, a plane at a time, so
+// the number of edges from every node into a set costs one pass over the
+// rows of its members instead of one pass per node.
+class Slice_Counter
 {
-  int i;
-  vector<int> nodes;
-  Graph::Vertices all_nodes(g);
-  all_nodes.fill();
-  all_nodes.node_array(nodes);
-  Graph::Vertices new_members(g);
+  int nw;
+  vector<vector<unsigned long> > planes;
+  vector<unsigned long> carry;
+  vector<unsigned long> eq;
 
-  //cerr << "glom is " << glom << endl;
+  public:
+  Slice_Counter(int num_words) :nw(num_words), carry(num_words),
+                                                     eq(num_words) {}
+
+  void add(const unsigned long *row)
+  {
+    int i, k;
+    unsigned long t, any;
+    unsigned long *p;
+
+    carry.assign(row, row + nw);
+    for (k=0; ; ++k)
+    {
+      if (k == (int)planes.size()) planes.push_back(vector<unsigned long>(nw, 0));
+      p = &planes[k][0];
+      any = 0;
+      for (i=0; i<nw; ++i)
+      {
+        t = p[i] & carry[i];
+        p[i] ^= carry[i];
+        carry[i] = t;
+        any |= t;
+      }
+      if (any == 0) break;
+    }
+  }
+
+  // Set dest to the nodes whose count is at least t, comparing all counts
+  // with t bit by bit from the top plane down
+  void at_least(int t, unsigned long *dest)
+  {
+    int i, k;
+    const unsigned long *p;
 
-//  do           //comment in this loop to do layered paraclique
-//  {
-    new_members.clear();
-    for (i=0; i<g.size(); i++)
+    if (t <= 0)
     {
-      if (!v.in_set(nodes[i]))  //if vertex is not already in paraclique, check whether it belongs
+      for (i=0; i<nw; ++i) dest[i] = ~0UL;
+      return;
+    }
+    if ((unsigned long)t >> planes.size() != 0)
+    {
+      for (i=0; i<nw; ++i) dest[i] = 0;
+      return;
+    }
+    for (i=0; i<nw; ++i) {dest[i] = 0; eq[i] = ~0UL;}
+    for (k=planes.size()-1; k>=0; --k)
+    {
+      p = &planes[k][0];
+      if ((t >> k) & 1)
       {
-        if (glom >= 1)                   //glom is number of edges that can be missing
-        {
-          if ((v.size() - v.degree(nodes[i])) <= glom) new_members.insert(nodes[i]);
-        }
-        else                             //glom is percentage of edges that must be present
-        {
-          double percent = (double)v.degree(nodes[i]) / (double)v.size();
-          if (percent >= glom)
-          {    
-            new_members.insert(nodes[i]);
-            //cerr << "vertex is connected to " << percent << "% of vertices in clique, adding to paraclique\n";
-          }        
-          //else              
-            //cerr << " vertex not added to paraclique\n";
-        }
+        for (i=0; i<nw; ++i) eq[i] &= p[i];
       }
+      else
+      {
+        for (i=0; i<nw; ++i) {dest[i] |= eq[i] & p[i]; eq[i] &= ~p[i];}
+      }
+    }
+    for (i=0; i<nw; ++i) dest[i] |= eq[i];
+  }
+};
+
+// Least number of edges into a paraclique of size nodes that a node needs
+// to join it.  A glom of 1 or more is the number of edges that can be
+// missing; below 1 it is the fraction of edges that must be present.
+static int glom_threshold(int size, double glom)
+{
+  int t;
+
+  if (glom >= 1) return (int)ceil(size - glom);
+  if (size == 0) return 1;
+  t = (int)ceil(glom * size);
+  while (t > 0 && (double)(t-1) / (double)size >= glom) --t;
+  while (t <= size && (double)t / (double)size < glom) ++t;
+  return t;
+}
+
+// Add to v every node of g outside v with at least t edges into v, as
+// counted by c, and return them in added
+static void glom_nodes(Graph &g, Graph::Vertices &v, Slice_Counter &c,
+                       int t, vector<int> &added)
+{
+  int i, b;
+  unsigned long w;
+  vector<unsigned long> mask(v.num_words());
+  Graph::Vertices all_nodes(g);
+  const unsigned long *all, *in;
+
+  all_nodes.fill();
+  all = all_nodes.words();
+  in = v.words();
+  c.at_least(t, &mask[0]);
+  added.clear();
+  for (i=0; i<v.num_words(); i++)
+  {
+    for (w = mask[i] & all[i] & ~in[i]; w != 0;
+                                  w &= ~(1UL << (NUM_ULBITS - 1 - b)))
+    {
+      b = __builtin_clzl(w);
+      added.push_back(i * NUM_ULBITS + b);
     }
-    v.insert(new_members);
-    //cerr << "Added " << new_members.size() << " for a paraclique of size " << v.size() << endl;
-//  } while (new_members.size() > 0);
+  }
+  for (i=0; i<(int)added.size(); ++i) v.insert(added[i]);
+}
+
+void build_paracl(Graph &g, Graph::Vertices &v, double glom)
+{
+  int i;
+  vector<int> members, added;
+  Slice_Counter counts(v.num_words());
+
+  //cerr << "glom is " << glom << endl;
 
+  v.node_array(members);
+  for (i=0; i<(int)members.size(); i++) counts.add(g.row(members[i]));
+
+  // For layered paraclique, add the rows of added to counts and repeat
+  // until nothing is added
+  glom_nodes(g, v, counts, glom_threshold(members.size(), glom), added);
+  //cerr << "Added " << added.size() << " for a paraclique of size " << v.size() << endl;
 }
 
+// The glom factor grows by one per round, and the counts are kept across
+// rounds:  only the rows of the nodes added in a round are counted again.
 void build_acc_paracl(Graph &g, Graph::Vertices &v, int agg_factor)
 {
   int i;
   int glom = 1;
-  vector<int> nodes;
-  Graph::Vertices all_nodes(g);
-  all_nodes.fill();
-  all_nodes.node_array(nodes);
-  Graph::Vertices new_members(g);
+  int size;
+  vector<int> members, added;
+  Slice_Counter counts(v.num_words());
+
+  v.node_array(members);
+  for (i=0; i<(int)members.size(); i++) counts.add(g.row(members[i]));
+  size = members.size();
 
   do
   {
-    new_members.clear();
-    for (i=0; i<g.size(); i++)
+    glom_nodes(g, v, counts, size - glom, added);
+    for (i=0; i<(int)added.size(); i++) counts.add(g.row(added[i]));
+    size += added.size();
+    ++glom;
+    //cerr << "Added " << added.size() << " for a paraclique of size " << v.size() << endl;
+  } while (agg_factor * glom <= size);
+}
+
+void build_paracl(const Sparse_Graph &sg, const vector<char> &alive,
+                  vector<int> &members, double glom)
+{
+  int i, n;
+  int size = members.size();
+  const int *p;
+  vector<char> in_set(sg.size(), 0);
+  vector<int> count(sg.size(), 0);
+  vector<int> new_members;
+
+  // Count edges into the paraclique, touching only its neighborhoods
+  for (i=0; i<size; ++i) in_set[members[i]] = 1;
+  for (i=0; i<size; ++i)
+    for (p = sg.nbrs_begin(members[i]); p != sg.nbrs_end(members[i]); ++p)
+                                                                 ++count[*p];
+
+  for (n=0; n<sg.size(); ++n)
+  {
+    if (!alive[n] || in_set[n]) continue;
+    if (glom >= 1)                   //glom is number of edges that can be missing
     {
-      if (!v.in_set(nodes[i]))
-      {
-        if ((v.size() - v.degree(nodes[i])) <= glom) new_members.insert(nodes[i]);
-      }
+      if (size - count[n] <= glom) new_members.push_back(n);
     }
-    v.insert(new_members);
-    ++glom;
-    //cerr << "Added " << new_members.size() << " for a paraclique of size " << v.size() << endl;
-  } while (agg_factor * glom <= v.size());
+    else                             //glom is percentage of edges that must be present
+    {
+      if ((double)count[n] / (double)size >= glom) new_members.push_back(n);
+    }
+  }
+
+  members.insert(members.end(), new_members.begin(), new_members.end());
+  sort(members.begin(), members.end());
 }
@@ -1,9 +1,16 @@
 #ifndef _PARACL_H
 #define _PARACL_H 1
 
+#include <vector>
 #include "Graph.h"
+#include "Sparse_Graph.h"
 
 void build_paracl(Graph &g, Graph::Vertices &v, double glom);
 void build_acc_paracl(Graph &g, Graph::Vertices &v, int agg_factor);
 
+// Sparse equivalent of build_paracl.  members holds the clique on entry and
+// the paraclique (sorted) on exit; only alive vertices are considered.
+void build_paracl(const Sparse_Graph &sg, const std::vector<char> &alive,
+                  std::vector<int> &members, double glom);
+
 #endif
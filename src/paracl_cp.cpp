@@ -8,6 +8,10 @@
 #include "Graph.h"
 #include "paracl.h"
 #include "Maxclique_Finder.h"
+#include "Sparse_Graph.h"
+#include "Graph_Handle.h"
+#include "Components.h"
+#include "color.h"
 //#include <cstdlib>
 
 // SVP:  Libraries for parallel version only
@@ -20,49 +24,296 @@ using namespace std;
 using namespace Rcpp;
 using std::vector;
 
-// [[Rcpp::export]]
-std::vector<std::vector<std::string> > find_paracliques(std::string filename, double igf, int min_mc_size, int min_pc_size, int max_num_pcs)
+// Paraclique extraction on the sparse backend, for graphs too large for a
+// dense adjacency matrix.
+static std::vector<std::vector<std::string> > find_sparse_paracliques(
+       const Sparse_Graph &sg, double igf, int min_mc_size, int min_pc_size,
+                                                           int max_num_pcs)
 {
-  int i;
-  Graph::Vertices *maximum_clique;
+  int i, j;
+  vector<char> alive(sg.size(), 1);
+  vector<int> paraclique;
   std::vector< std::vector<string> > paracliques;
 
- 
-  // SVP:  Parallel initialization
-  /*#ifdef PARALLEL
-  par_init(&argc, &argv);
-#endif*/
+  if (max_num_pcs <= 0) max_num_pcs = sg.size();
 
+  for (i=0; i<max_num_pcs; ++i)
+  {
+    if (find_mc(sg, alive, paraclique) < min_mc_size) break;
 
-  string graph_file(filename);
-  Graph *g = new Graph(graph_file);
+    build_paracl(sg, alive, paraclique, igf);
+    if ((int)paraclique.size() < min_pc_size) break;
+
+    paracliques.push_back(std::vector<string>());
+    for (j=0; j<(int)paraclique.size(); ++j)
+    {
+      paracliques.back().push_back(sg.label(paraclique[j]));
+      alive[paraclique[j]] = 0;
+    }
+  }
+  return paracliques;
+}
+
+// A component of the graph left by paraclique extraction.  Its maximum
+// clique is only searched for once the component could hold the largest
+// clique of the graph, and is kept until a paraclique is taken from it.
+// Removing nodes never enlarges a clique, so what is left of a searched
+// component is bounded by its maximum clique size (limit).  A piece whose
+// pool still holds a clique of that size needs no search at all, and the
+// search of any other piece ends as soon as it reaches that size.
+struct Paraclique_Component
+{
+  std::vector<int> nodes;
+  int bound;                   // Upper bound until searched, then exact
+  int limit;                   // Known upper bound (0 if none)
+  bool searched;
+  std::vector<int> clique;
+  std::vector<std::vector<int> > pool;  // Cliques, largest first
+};
+
+struct Larger_Clique
+{
+  bool operator() (const std::vector<int> &a, const std::vector<int> &b) const
+                                               {return a.size() > b.size();}
+};
+
+// Grow a clique greedily from each node of a component, always adding the
+// candidate with the most neighbors among the candidates, and keep the
+// distinct ones with at least min_size nodes in pool, largest first
+static void grow_cliques(Graph *g, const std::vector<int> &nodes,
+                  int min_size, std::vector<std::vector<int> > &pool)
+{
+  int i, j, n, d, best_n, best_d;
+  Graph::Vertices cands(*g);
+  std::vector<int> members, clique;
+
+  pool.clear();
+  for (i=0; i<(int)nodes.size(); ++i)
+  {
+    if (g->degree(nodes[i]) + 1 < min_size) continue;
+    clique.assign(1, nodes[i]);
+    cands.clear();
+    cands.insert_nbrs(nodes[i]);
+    while (1)
+    {
+      cands.node_array(members);
+      if (members.empty()) break;
+      best_n = members[0];
+      best_d = -1;
+      for (j=0; j<(int)members.size(); ++j)
+      {
+        n = members[j];
+        d = cands.degree(n);
+        if (d > best_d) {best_d = d; best_n = n;}
+      }
+      clique.push_back(best_n);
+      cands.remove_nnbrs(best_n);
+      cands.remove(best_n);
+    }
+    if ((int)clique.size() < min_size) continue;
+    sort(clique.begin(), clique.end());
+    pool.push_back(clique);
+  }
+  sort(pool.begin(), pool.end());
+  pool.erase(unique(pool.begin(), pool.end()), pool.end());
+  stable_sort(pool.begin(), pool.end(), Larger_Clique());
+}
+
+// Split nodes of g into components and add those that could hold a clique
+// of min_mc_size nodes, unsearched, to comps.  limit is a known upper bound
+// on their clique size (0 if none), and each clique of pool goes to the
+// pool of the component that holds it.
+static void add_components(Graph *g, const Graph::Vertices &nodes,
+                           int min_mc_size, int limit,
+                           const std::vector<std::vector<int> > &pool,
+                           std::vector<Paraclique_Component> &comps)
+{
+  int i, j;
+  int first = comps.size();
+  Bitset_Coloring coloring;
+  Graph::Vertices v(*g);
+  std::vector<std::vector<int> > found;
+  std::vector<int> order, colors;
+  std::vector<int> comp_of(g->max_size(), -1);
+
+  connected_components(nodes, found);
+  for (i=0; i<(int)found.size(); ++i)
+  {
+    if ((int)found[i].size() < min_mc_size) continue;
+    v.clear();
+    for (j=0; j<(int)found[i].size(); ++j)
+    {
+      v.insert(found[i][j]);
+      comp_of[found[i][j]] = comps.size();
+    }
+    comps.push_back(Paraclique_Component());
+    comps.back().nodes.swap(found[i]);
+    comps.back().bound = coloring.color(v, order, colors);
+    if (limit > 0) comps.back().bound = min(comps.back().bound, limit);
+    comps.back().limit = limit;
+    comps.back().searched = 0;
+  }
+
+  // A clique lies in one component; pool is largest first, and so are the
+  // pools built from it
+  for (i=0; i<(int)pool.size(); ++i)
+  {
+    j = comp_of[pool[i][0]];
+    if (j >= first) comps[j].pool.push_back(pool[i]);
+  }
+}
+
+// Find the maximum clique of a component, on a copy of the component alone
+static void search_component(Graph *g, Paraclique_Component &c,
+                                                         int min_mc_size)
+{
+  // A clique as large as the known bound is a maximum clique
+  if (c.limit > 0 && !c.pool.empty() && (int)c.pool[0].size() >= c.limit)
+  {
+    c.clique = c.pool[0];
+    c.bound = c.clique.size();
+    c.searched = 1;
+    return;
+  }
+
+  Graph *sub = component_graph(*g, c.nodes);
+  Graph::Vertices *maximum_clique = find_mc(sub, c.limit);
+
+  c.clique.clear();
+  Graph::Vertices::Vex_ptr vp(*maximum_clique);
+  for (; !vp.end(); ++vp) c.clique.push_back(g->vertex(sub->label(*vp)));
+  c.bound = c.clique.size();
+  c.searched = 1;
+  delete maximum_clique;
+  delete sub;
+
+  // Stock the pool for the pieces the component will be split into
+  grow_cliques(g, c.nodes, min_mc_size, c.pool);
+}
+
+static bool overlaps(const Graph::Vertices &v, const std::vector<int> &nodes)
+{
+  int i;
+  for (i=0; i<(int)nodes.size(); ++i) if (v.in_set(nodes[i])) return 1;
+  return 0;
+}
+
+// Paraclique extraction on a dense graph.  Paracliques are removed from g
+// as they are found.  The graph is kept as a list of components, and only
+// the components a paraclique was taken from are split and searched again.
+static std::vector<std::vector<std::string> > find_dense_paracliques(
+                  Graph *g, double igf, int min_mc_size, int min_pc_size,
+                                                          int max_num_pcs)
+{
+  int i, j, k, n, best, limit;
+  std::vector< std::vector<string> > paracliques;
+  std::vector<Paraclique_Component> comps;
+  std::vector<std::vector<int> > pool;
   Graph::Vertices paraclique(*g);
+  Graph::Vertices rest(*g);
   //igf = atof(argv[2]); 
-  min_mc_size = max(3, min_mc_size);
-  min_pc_size = max(3, min_pc_size);
 //  max_num_pcs = atoi(argv[5]);
   if (max_num_pcs <= 0) max_num_pcs = g->size();
 
+  rest.fill();
+  add_components(g, rest, min_mc_size, 0, pool, comps);
+
   for (i=0; i<max_num_pcs; ++i)
   {
-    // Use copy of graph for finding maximum clique (find_mc is destructive)
-    Graph g_copy(*g);
-    maximum_clique = find_mc(&g_copy);
-    //cerr << "Maximum clique size is:  " << maximum_clique->size() << endl;
-    if (maximum_clique->size() < min_mc_size) break;
+    // Search components, highest bound first, until one holds a maximum
+    // clique of the whole graph
+    while (1)
+    {
+      best = -1;
+      for (j=0; j<(int)comps.size(); ++j)
+      {
+        if (best < 0 || comps[j].bound > comps[best].bound ||
+            (comps[j].bound == comps[best].bound && comps[j].searched &&
+                                                    !comps[best].searched))
+          best = j;
+      }
+      if (best < 0 || comps[best].searched ||
+                             comps[best].bound < min_mc_size) break;
+      search_component(g, comps[best], min_mc_size);
+    }
+    if (best < 0) break;
+    //cerr << "Maximum clique size is:  " << comps[best].bound << endl;
+    if (comps[best].bound < min_mc_size) break;
  
     // Extract results
     paraclique.clear();
-    Graph::Vertices::Vex_ptr vp(*maximum_clique);
-    for (; !vp.end(); ++vp) paraclique.insert(g->vertex(g_copy.label(*vp)));
-    delete maximum_clique;
+    for (j=0; j<(int)comps[best].clique.size(); ++j)
+                                      paraclique.insert(comps[best].clique[j]);
 
     build_paracl(*g, paraclique, igf);
     if (paraclique.size() < min_pc_size) break;
 
     paracliques.push_back(print_vertices_oneline(paraclique));
     g->remove(paraclique);
+
+    // Split up what is left of each component the paraclique took nodes
+    // from (only the one its clique came from, unless glomming reaches
+    // nodes with no edge into the clique).  No piece holds a clique larger
+    // than the one just used, which is a maximum clique of the graph, and
+    // the pooled cliques that miss the paraclique are still cliques.
+    limit = comps[best].bound;
+    rest.clear();
+    pool.clear();
+    for (j=0; j<(int)comps.size(); )
+    {
+      n = comps[j].nodes.size();
+      for (k=0; k<n; ++k) if (paraclique.in_set(comps[j].nodes[k])) break;
+      if (k == n) {++j; continue;}
+
+      for (k=0; k<n; ++k)
+      {
+        if (!paraclique.in_set(comps[j].nodes[k]))
+                                             rest.insert(comps[j].nodes[k]);
+      }
+      for (k=0; k<(int)comps[j].pool.size(); ++k)
+      {
+        if (!overlaps(paraclique, comps[j].pool[k]))
+                                           pool.push_back(comps[j].pool[k]);
+      }
+      swap(comps[j], comps.back());
+      comps.pop_back();
+    }
+    stable_sort(pool.begin(), pool.end(), Larger_Clique());
+    add_components(g, rest, min_mc_size, limit, pool, comps);
+  }
+  return paracliques;
+}
+
+// [[Rcpp::export]]
+std::vector<std::vector<std::string> > find_paracliques(std::string filename, double igf, int min_mc_size, int min_pc_size, int max_num_pcs)
+{
+  std::vector< std::vector<string> > paracliques;
+
+ 
+  // SVP:  Parallel initialization
+  /*#ifdef PARALLEL
+  par_init(&argc, &argv);
+#endif*/
+
+
+  string graph_file(filename);
+  min_mc_size = max(3, min_mc_size);
+  min_pc_size = max(3, min_pc_size);
+
+  int header_nodes;
+  long header_edges;
+  read_graph_header(graph_file, header_nodes, header_edges);
+  if (use_sparse_backend(header_nodes, header_edges))
+  {
+    Sparse_Graph sg(graph_file);
+    return find_sparse_paracliques(sg, igf, min_mc_size, min_pc_size,
+                                                         max_num_pcs);
   }
+
+  Graph *g = new Graph(graph_file);
+  paracliques = find_dense_paracliques(g, igf, min_mc_size, min_pc_size,
+                                                            max_num_pcs);
+  delete g;
   return paracliques;
   
   /* SVP:  For parallel version, allow parallel library to properly exit
@@ -70,3 +321,38 @@ std::vector<std::vector<std::string> > find_paracliques(std::string filename, do
   par_exit();
   #endif*/
 }
+
+// Same as find_paracliques for a graph loaded with cliqueR.load.  Results
+// are cached on the handle for each set of arguments.
+// [[Rcpp::export]]
+std::vector<std::vector<std::string> > handle_find_paracliques(SEXP handle, double igf, int min_mc_size, int min_pc_size, int max_num_pcs)
+{
+  Graph_Handle *h = graph_handle(handle);
+
+  min_mc_size = max(3, min_mc_size);
+  min_pc_size = max(3, min_pc_size);
+  if (max_num_pcs <= 0) max_num_pcs = -1;
+
+  vector<double> key;
+  key.push_back(igf);
+  key.push_back(min_mc_size);
+  key.push_back(min_pc_size);
+  key.push_back(max_num_pcs);
+
+  map<vector<double>, vector<vector<string> > >::iterator it;
+  it = h->paracliques.find(key);
+  if (it != h->paracliques.end()) return it->second;
+
+  std::vector< std::vector<string> > paracliques;
+  if (h->sparse_graph())
+    paracliques = find_sparse_paracliques(*h->sparse_graph(), igf, min_mc_size,
+                                                  min_pc_size, max_num_pcs);
+  else
+  {
+    Graph g_copy(*h->graph());
+    paracliques = find_dense_paracliques(&g_copy, igf, min_mc_size,
+                                                  min_pc_size, max_num_pcs);
+  }
+  h->paracliques[key] = paracliques;
+  return paracliques;
+}
@@ -0,0 +1,56 @@
+/* On-disk layout of cliqueR graph snapshots */
+/* Shared by the C++ engines (Snapshot.h) and the C maximal clique engine */
+/* (graph_maximal.c), so it is kept plain C. */
+/*
+   A snapshot is a parsed edge list saved in binary form so it can be
+   memory-mapped instead of re-parsed.  The file starts with a fixed
+   header followed by sections, each starting on a SNAPSHOT_ALIGN boundary
+   so that any of them can be mapped on its own:
+
+     label index   uint64[n+1]  byte offsets into the label data
+     label data    char[]       NUL-terminated labels of nodes 0..n-1
+     degrees       uint32[n]
+     CSR index     uint64[n+1]  neighbors of u are adj[index[u]..index[u+1])
+     CSR adj       uint32[2m]   sorted within each row
+     dense rows    optional; the C++ Graph bit matrix, row_words words of
+                   word_bytes bytes per row, exactly as Graph lays it out
+
+   Integers are stored in the writer's byte order; byte_order tells a
+   reader whether it can use the file.  Readers must reject any version
+   they do not know.
+*/
+
+#ifndef __SNAPSHOT_FORMAT_H
+#define __SNAPSHOT_FORMAT_H
+
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC       "CLQRSNAP"
+#define SNAPSHOT_MAGIC_LEN   8
+#define SNAPSHOT_VERSION     1
+#define SNAPSHOT_BYTE_ORDER  0x01020304u
+#define SNAPSHOT_ALIGN       65536   /* >= the page size on all platforms */
+
+/* flags */
+#define SNAPSHOT_DENSE       1       /* dense rows are present */
+
+typedef struct snapshot_header_t {
+  char magic[SNAPSHOT_MAGIC_LEN];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t flags;
+  uint32_t word_bytes;        /* size of a dense row word */
+  uint64_t row_words;         /* words per dense row, including padding */
+  uint64_t num_nodes;
+  uint64_t num_edges;         /* undirected, no loops or duplicates */
+  uint64_t label_index_off;
+  uint64_t label_data_off;
+  uint64_t degree_off;
+  uint64_t csr_index_off;
+  uint64_t csr_adj_off;
+  uint64_t dense_off;         /* 0 when there are no dense rows */
+  uint64_t dense_bytes;
+  uint64_t file_bytes;
+} snapshot_header;
+
+#endif  /* __SNAPSHOT_FORMAT_H */